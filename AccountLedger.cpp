@@ -0,0 +1,275 @@
+// ==================== AccountLedger.cpp ====================
+/**
+ * AccountLedger.cpp
+ * Implementation of the sharded account ledger
+ */
+
+#include "AccountLedger.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+const std::string AccountLedger::MARKET = "dataset";
+
+AccountLedger::AccountLedger(size_t shardCount)
+    : shards(std::max<size_t>(1, shardCount))
+{
+}
+
+size_t AccountLedger::shardIndex(const std::string& account) const
+{
+    return std::hash<std::string>()(account) % shards.size();
+}
+
+AccountLedger::Shard& AccountLedger::shardFor(const std::string& account)
+{
+    return shards[shardIndex(account)];
+}
+
+const AccountLedger::Shard& AccountLedger::shardFor(const std::string& account) const
+{
+    return shards[shardIndex(account)];
+}
+
+// ==================== SINGLE ACCOUNT ====================
+
+void AccountLedger::deposit(const std::string& account, const std::string& currency, double amount)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.accounts[account].insertCurrency(currency, amount);
+}
+
+bool AccountLedger::withdraw(const std::string& account, const std::string& currency, double amount)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it != shard.accounts.end() && it->second.removeCurrency(currency, amount);
+}
+
+bool AccountLedger::containsCurrency(const std::string& account, const std::string& currency, double amount) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it != shard.accounts.end() && it->second.containsCurrency(currency, amount);
+}
+
+bool AccountLedger::canFulfilOrder(const std::string& account, const OrderBookEntry& order) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it != shard.accounts.end() && it->second.canFulfilOrder(order);
+}
+
+double AccountLedger::getBalance(const std::string& account, const std::string& currency) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it == shard.accounts.end() ? 0.0 : it->second.getBalance(currency);
+}
+
+bool AccountLedger::hasAccount(const std::string& account) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.accounts.find(account) != shard.accounts.end();
+}
+
+void AccountLedger::removeAccount(const std::string& account)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.accounts.erase(account);
+}
+
+double AccountLedger::getAvailable(const std::string& account, const std::string& currency) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it == shard.accounts.end() ? 0.0 : it->second.getAvailable(currency);
+}
+
+bool AccountLedger::reserve(const std::string& account, const OrderBookEntry& order)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it != shard.accounts.end() && it->second.reserve(order);
+}
+
+void AccountLedger::release(const std::string& account, unsigned long long orderId)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    if (it != shard.accounts.end())
+    {
+        it->second.release(orderId);
+    }
+}
+
+bool AccountLedger::cancel(OrderBook& orderBook, const std::string& account, unsigned long long orderId)
+{
+    Shard& shard = shardFor(account);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    if (it == shard.accounts.end() || !orderBook.cancelOrder(orderId, account))
+    {
+        return false;
+    }
+
+    it->second.release(orderId);
+    return true;
+}
+
+bool AccountLedger::isReserved(const std::string& account, unsigned long long orderId) const
+{
+    if (account == MARKET)
+    {
+        return true;
+    }
+
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it != shard.accounts.end() && it->second.isReserved(orderId);
+}
+
+Wallet AccountLedger::getWallet(const std::string& account) const
+{
+    const Shard& shard = shardFor(account);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.accounts.find(account);
+    return it == shard.accounts.end() ? Wallet() : it->second;
+}
+
+size_t AccountLedger::getAccountCount() const
+{
+    size_t count = 0;
+    for (const Shard& shard : shards)
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        count += shard.accounts.size();
+    }
+    return count;
+}
+
+// ==================== SETTLEMENT ====================
+
+std::map<std::string, std::map<std::string, double>> AccountLedger::settle(std::vector<Trade>& trades,
+    size_t& refused,
+    unsigned threads)
+{
+    // Every user side must still hold its reservation: a reservation covers
+    // all of its order's fills, so checking before any is applied is enough
+    size_t before = trades.size();
+    trades.erase(std::remove_if(trades.begin(), trades.end(), [this](const Trade& trade)
+    {
+        return !isReserved(trade.buyer, trade.bidId) || !isReserved(trade.seller, trade.askId);
+    }), trades.end());
+    refused += before - trades.size();
+
+    // Route each side of each trade to its account's shard; the fills are
+    // built by the worker that settles the shard
+    struct Side
+    {
+        size_t trade;
+        bool buyer;
+    };
+    std::vector<std::vector<Side>> routed(shards.size());
+    for (size_t i = 0; i < trades.size(); i++)
+    {
+        if (trades[i].buyer != MARKET)
+        {
+            routed[shardIndex(trades[i].buyer)].push_back(Side{ i, true });
+        }
+        if (trades[i].seller != MARKET)
+        {
+            routed[shardIndex(trades[i].seller)].push_back(Side{ i, false });
+        }
+    }
+
+    std::vector<size_t> jobs;
+    for (size_t s = 0; s < routed.size(); s++)
+    {
+        if (!routed[s].empty()) jobs.push_back(s);
+    }
+
+    // Workers claim whole shards, so each shard lock is taken once and no two
+    // workers touch the same account
+    typedef std::vector<std::pair<std::string, std::map<std::string, double>>> Changes;
+    std::vector<Changes> changes(shards.size());
+    std::atomic<size_t> nextJob(0);
+    auto work = [&]()
+    {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++)
+        {
+            size_t s = jobs[j];
+
+            // Group the shard's sides by account, keeping their order
+            std::unordered_map<std::string, size_t> slots;
+            std::vector<std::vector<const Side*>> groups;
+            for (const Side& side : routed[s])
+            {
+                const Trade& trade = trades[side.trade];
+                const std::string& account = side.buyer ? trade.buyer : trade.seller;
+                auto slot = slots.find(account);
+                if (slot == slots.end())
+                {
+                    slot = slots.emplace(account, groups.size()).first;
+                    groups.emplace_back();
+                }
+                groups[slot->second].push_back(&side);
+            }
+
+            Shard& shard = shards[s];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::vector<OrderBookEntry> fills;
+            for (const std::vector<const Side*>& group : groups)
+            {
+                fills.clear();
+                for (const Side* side : group)
+                {
+                    const Trade& trade = trades[side->trade];
+                    fills.push_back(side->buyer ? trade.buyerFill() : trade.sellerFill());
+                }
+                const std::string& account = fills.front().username;
+                changes[s].emplace_back(account, shard.accounts[account].settle(fills));
+            }
+        }
+    };
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, jobs.size()));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::map<std::string, std::map<std::string, double>> result;
+    for (Changes& shardChanges : changes)
+    {
+        for (auto& change : shardChanges)
+        {
+            result[change.first] = std::move(change.second);
+        }
+    }
+    return result;
+}
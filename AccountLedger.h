@@ -0,0 +1,79 @@
+// ==================== AccountLedger.h ====================
+/**
+ * AccountLedger.h
+ * Balances of every account on the exchange
+ * TASK 3: Accounts are spread over shards by a hash of the username, each
+ * shard with its own lock, so operations on different accounts rarely
+ * contend. A timeframe's trades are settled for both participants, with the
+ * shards settled in parallel
+ */
+
+#pragma once
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OrderBook.h"
+#include "OrderBookEntry.h"
+#include "Trade.h"
+#include "Wallet.h"
+
+class AccountLedger
+{
+public:
+    // Orders loaded from the data file belong to this account; it is the
+    // market's liquidity and is never settled
+    static const std::string MARKET;
+
+    explicit AccountLedger(size_t shardCount = 64);
+
+    void deposit(const std::string& account, const std::string& currency, double amount);
+    bool withdraw(const std::string& account, const std::string& currency, double amount);
+    bool containsCurrency(const std::string& account, const std::string& currency, double amount) const;
+    bool canFulfilOrder(const std::string& account, const OrderBookEntry& order) const;
+    double getBalance(const std::string& account, const std::string& currency) const;
+    double getAvailable(const std::string& account, const std::string& currency) const;
+
+    // Check and reservation happen under the shard lock, so two orders cannot
+    // both pass against the same funds
+    bool reserve(const std::string& account, const OrderBookEntry& order);
+    void release(const std::string& account, unsigned long long orderId);
+
+    // Removes the account's order from the book and releases its reservation
+    // under the same shard lock; false if the account has no such order
+    bool cancel(OrderBook& orderBook, const std::string& account, unsigned long long orderId);
+
+    bool hasAccount(const std::string& account) const;
+
+    // Drops the account's wallet and reservations; a later deposit opens it
+    // again empty
+    void removeAccount(const std::string& account);
+
+    // Copy of the account's wallet (empty if the account is unknown)
+    Wallet getWallet(const std::string& account) const;
+    size_t getAccountCount() const;
+
+    // Applies every trade to its buyer and seller. Returns, per account, the
+    // new balance of every currency that moved. threads == 0 uses every core.
+    // A trade whose user order has no reservation behind it is refused:
+    // removed from trades and counted in refused, so it can never overdraw
+    // a wallet
+    std::map<std::string, std::map<std::string, double>> settle(std::vector<Trade>& trades,
+        size_t& refused,
+        unsigned threads = 0);
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Wallet> accounts;
+    };
+
+    Shard& shardFor(const std::string& account);
+    const Shard& shardFor(const std::string& account) const;
+    size_t shardIndex(const std::string& account) const;
+    bool isReserved(const std::string& account, unsigned long long orderId) const;
+
+    std::vector<Shard> shards;
+};
@@ -0,0 +1,199 @@
+// ==================== AgentSimulation.cpp ====================
+/**
+ * AgentSimulation.cpp
+ * Implementation of the simulated traders
+ */
+
+#include "AgentSimulation.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+AgentSimulation::AgentSimulation(const Config& _config, const std::vector<std::string>& _products)
+    : config(_config),
+    products(_products)
+{
+    int total = config.marketMakers + config.takers + config.randomWalkers;
+    agents.reserve(total);
+
+    for (int i = 0; i < total; i++)
+    {
+        Agent agent;
+        if (i < config.marketMakers)
+            agent.strategy = Strategy::marketMaker;
+        else if (i < config.marketMakers + config.takers)
+            agent.strategy = Strategy::taker;
+        else
+            agent.strategy = Strategy::randomWalker;
+
+        char account[32];
+        std::snprintf(account, sizeof(account), "agent-%06d", i);
+        agent.account = account;
+        agent.product = products.empty() ? 0 : i % products.size();
+
+        // Seeded from the run's seed and the agent's index only, so an agent
+        // draws the same numbers whichever thread generates it
+        std::seed_seq seq{ (std::uint32_t)(config.seed >> 32), (std::uint32_t)config.seed,
+            (std::uint32_t)i };
+        agent.rng.seed(seq);
+        agent.offset = 0.0;
+
+        agents.push_back(std::move(agent));
+    }
+}
+
+void AgentSimulation::fund(AccountLedger& ledger, const std::map<std::string, double>& prices)
+{
+    if (products.empty())
+    {
+        return;
+    }
+
+    for (const Agent& agent : agents)
+    {
+        ledger.removeAccount(agent.account);
+
+        const std::string& product = products[agent.product];
+        auto price = prices.find(product);
+        size_t slash = product.find('/');
+        if (price == prices.end() || slash == std::string::npos)
+        {
+            continue;
+        }
+
+        ledger.deposit(agent.account, product.substr(0, slash), config.funding);
+        ledger.deposit(agent.account, product.substr(slash + 1), config.funding * price->second);
+    }
+}
+
+// ==================== ORDER GENERATION ====================
+
+std::vector<OrderBookEntry> AgentSimulation::generate(const std::string& timestamp,
+    const std::map<std::string, double>& prices,
+    AccountLedger& ledger,
+    unsigned long long firstOrderId,
+    size_t& rejected)
+{
+    // Index the reference prices by product once; 0 means no price this timeframe
+    std::vector<double> reference(products.size(), 0.0);
+    for (size_t p = 0; p < products.size(); p++)
+    {
+        auto price = prices.find(products[p]);
+        if (price != prices.end()) reference[p] = price->second;
+    }
+
+    unsigned threads = config.threads;
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, agents.size()));
+
+    // Each thread takes a contiguous slice of agents; the slices are joined in
+    // agent order so the batch is the same for any thread count
+    std::vector<std::vector<OrderBookEntry>> slices(threads);
+    std::vector<size_t> sliceRejected(threads, 0);
+    size_t perThread = (agents.size() + threads - 1) / threads;
+    auto work = [&](unsigned t)
+    {
+        size_t first = std::min(agents.size(), t * perThread);
+        size_t last = std::min(agents.size(), first + perThread);
+        generateFor(first, last, timestamp, reference, ledger, firstOrderId,
+            slices[t], sliceRejected[t]);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+    {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    size_t total = 0;
+    for (const std::vector<OrderBookEntry>& slice : slices)
+    {
+        total += slice.size();
+    }
+
+    std::vector<OrderBookEntry> batch;
+    batch.reserve(total);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        batch.insert(batch.end(), std::make_move_iterator(slices[t].begin()),
+            std::make_move_iterator(slices[t].end()));
+        rejected += sliceRejected[t];
+    }
+    return batch;
+}
+
+void AgentSimulation::generateFor(size_t first, size_t last, const std::string& timestamp,
+    const std::vector<double>& prices, AccountLedger& ledger,
+    unsigned long long firstOrderId, std::vector<OrderBookEntry>& out, size_t& rejected)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (size_t i = first; i < last && !products.empty(); i++)
+    {
+        Agent& agent = agents[i];
+
+        // Random walkers move every timeframe, whether or not they trade
+        if (agent.strategy == Strategy::randomWalker)
+        {
+            // A fresh distribution per draw: a shared one caches its second
+            // value and would hand it to the next agent on the thread
+            std::normal_distribution<double> step(0.0, 1.0);
+            agent.offset = 0.9 * agent.offset + config.volatility * step(agent.rng);
+        }
+
+        double mid = prices[agent.product];
+        if (mid <= 0 || unit(agent.rng) >= config.activity)
+        {
+            continue;
+        }
+
+        const std::string& product = products[agent.product];
+        unsigned long long nextId = firstOrderId + i * MAX_ORDERS_PER_AGENT;
+        auto submit = [&](OrderBookType type, double price)
+        {
+            double amount = config.funding * (0.005 + 0.015 * unit(agent.rng));
+            OrderBookEntry order(price, amount, timestamp, product, type, agent.account);
+            order.orderId = nextId++;
+            if (ledger.reserve(agent.account, order))
+            {
+                out.push_back(std::move(order));
+            }
+            else
+            {
+                rejected++;
+            }
+        };
+
+        switch (agent.strategy)
+        {
+        case Strategy::marketMaker:
+            submit(OrderBookType::bid, mid * (1.0 - config.spread));
+            submit(OrderBookType::ask, mid * (1.0 + config.spread));
+            break;
+
+        case Strategy::taker:
+            // Priced through the market makers' quotes so it fills if any remain
+            if (unit(agent.rng) < 0.5)
+                submit(OrderBookType::bid, mid * (1.0 + 3 * config.spread));
+            else
+                submit(OrderBookType::ask, mid * (1.0 - 3 * config.spread));
+            break;
+
+        case Strategy::randomWalker:
+            // Buys when it believes the price is higher than the market's
+            if (agent.offset > 0)
+                submit(OrderBookType::bid, mid * (1.0 + agent.offset));
+            else
+                submit(OrderBookType::ask, mid * (1.0 + agent.offset));
+            break;
+        }
+    }
+}
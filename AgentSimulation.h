@@ -0,0 +1,80 @@
+// ==================== AgentSimulation.h ====================
+/**
+ * AgentSimulation.h
+ * Simulated traders that submit orders every timeframe
+ * TASK 4: Market makers quote both sides around the reference price, takers
+ * cross the spread and random walkers trade on a drifting private view of the
+ * price. Agents are generated in parallel, each from its own seeded random
+ * generator, so a run is reproducible whatever the thread count
+ */
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "AccountLedger.h"
+#include "OrderBookEntry.h"
+
+class AgentSimulation
+{
+public:
+    enum class Strategy { marketMaker, taker, randomWalker };
+
+    struct Config
+    {
+        int marketMakers = 1000;
+        int takers = 1000;
+        int randomWalkers = 1000;
+        int timeframes = 10;
+        unsigned threads = 0;           // 0 uses every core
+        std::uint64_t seed = 1;
+        double spread = 0.001;          // Market makers quote mid * (1 -/+ spread)
+        double volatility = 0.002;      // Random walkers' step per timeframe
+        double activity = 0.8;          // Chance an agent trades in a timeframe
+        double funding = 100.0;         // Base currency per agent, plus its value in quote
+    };
+
+    // Agents are spread over the products in turn
+    AgentSimulation(const Config& _config, const std::vector<std::string>& _products);
+
+    // Opens every agent's account with funds at the given reference prices.
+    // Accounts left from an earlier run are emptied first, so every run
+    // starts from the same balances
+    void fund(AccountLedger& ledger, const std::map<std::string, double>& prices);
+
+    // One timeframe's orders from every agent, in agent order. Each order is
+    // reserved in the ledger before it is returned; orders that cannot be
+    // reserved are counted in rejected and dropped. IDs are taken from the
+    // block starting at firstOrderId, getOrderIdCount() long
+    std::vector<OrderBookEntry> generate(const std::string& timestamp,
+        const std::map<std::string, double>& prices,
+        AccountLedger& ledger,
+        unsigned long long firstOrderId,
+        size_t& rejected);
+
+    size_t getAgentCount() const { return agents.size(); }
+    size_t getOrderIdCount() const { return agents.size() * MAX_ORDERS_PER_AGENT; }
+    const Config& getConfig() const { return config; }
+
+private:
+    static const size_t MAX_ORDERS_PER_AGENT = 2;
+
+    struct Agent
+    {
+        std::string account;
+        Strategy strategy;
+        size_t product;
+        std::mt19937_64 rng;
+        double offset;      // Random walker's view, relative to the reference price
+    };
+
+    void generateFor(size_t first, size_t last, const std::string& timestamp,
+        const std::vector<double>& prices, AccountLedger& ledger,
+        unsigned long long firstOrderId, std::vector<OrderBookEntry>& out, size_t& rejected);
+
+    Config config;
+    std::vector<std::string> products;
+    std::vector<Agent> agents;
+};
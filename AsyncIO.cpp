@@ -0,0 +1,449 @@
+// ==================== AsyncIO.cpp ====================
+/**
+ * AsyncIO.cpp
+ * Implementation of asynchronous appends (io_uring backend + thread pool fallback)
+ */
+
+#include "AsyncIO.h"
+#include <thread>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ASYNCIO_HAVE_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace
+{
+    // ==================== THREAD POOL BACKEND ====================
+
+    class ThreadPoolBackend : public AsyncIO::Backend
+    {
+    public:
+        ThreadPoolBackend(AsyncIO& _owner, unsigned threadCount)
+            : owner(_owner), stopping(false)
+        {
+            for (unsigned i = 0; i < threadCount; i++)
+            {
+                workers.emplace_back(&ThreadPoolBackend::run, this);
+            }
+        }
+
+        ~ThreadPoolBackend()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            ready.notify_all();
+            for (std::thread& worker : workers) worker.join();
+        }
+
+        void submitWrite(AsyncIO::Request* request) override { enqueue(request); }
+        void submitSync(AsyncIO::Request* request) override { enqueue(request); }
+        const char* name() const override { return "thread pool"; }
+
+    private:
+        void enqueue(AsyncIO::Request* request)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(request);
+            }
+            ready.notify_one();
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                AsyncIO::Request* request;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [this] { return !queue.empty() || stopping; });
+                    if (queue.empty()) return;
+                    request = queue.front();
+                    queue.pop_front();
+                }
+                owner.handleCompletion(request, execute(request));
+            }
+        }
+
+        static long long execute(AsyncIO::Request* request)
+        {
+            if (request->syncing)
+            {
+#ifdef _WIN32
+                return _commit(request->fd) == 0 ? 0 : -errno;
+#elif defined(__APPLE__)
+                return fsync(request->fd) == 0 ? 0 : -errno;
+#else
+                return fdatasync(request->fd) == 0 ? 0 : -errno;
+#endif
+            }
+
+            const char* data = request->data.data() + request->written;
+            size_t length = request->data.size() - request->written;
+#ifdef _WIN32
+            int result = _write(request->fd, data, (unsigned)length);
+#else
+            ssize_t result;
+            do
+            {
+                result = ::write(request->fd, data, length);
+            } while (result < 0 && errno == EINTR);
+#endif
+            return result < 0 ? -errno : (long long)result;
+        }
+
+        AsyncIO& owner;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<AsyncIO::Request*> queue;
+        std::vector<std::thread> workers;
+        bool stopping;
+    };
+
+#ifdef ASYNCIO_HAVE_URING
+    // ==================== IO_URING BACKEND ====================
+
+    class UringBackend : public AsyncIO::Backend
+    {
+    public:
+        UringBackend(AsyncIO& _owner)
+            : owner(_owner), ringFd(-1), sqPtr(nullptr), cqPtr(nullptr), sqes(nullptr),
+            sqSize(0), cqSize(0), sqesSize(0), stopping(false)
+        {
+        }
+
+        ~UringBackend()
+        {
+            if (reaper.joinable())
+            {
+                stopping = true;
+                submit(IORING_OP_NOP, -1, nullptr, 0, 0, WAKE_UP);
+                reaper.join();
+            }
+            if (sqes != nullptr) munmap(sqes, sqesSize);
+            if (cqPtr != nullptr && cqPtr != sqPtr) munmap(cqPtr, cqSize);
+            if (sqPtr != nullptr) munmap(sqPtr, sqSize);
+            if (ringFd >= 0) close(ringFd);
+        }
+
+        // Returns false if the kernel (or a sandbox) does not offer what we need
+        bool init(unsigned entries)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+            if (ringFd < 0) return false;
+
+            // Writes at the current position (appends) need Linux 5.6+
+            if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) return false;
+
+            sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap)
+            {
+                if (cqSize > sqSize) sqSize = cqSize;
+                cqSize = sqSize;
+            }
+
+            sqPtr = mapRing(sqSize, IORING_OFF_SQ_RING);
+            if (sqPtr == nullptr) return false;
+            cqPtr = singleMap ? sqPtr : mapRing(cqSize, IORING_OFF_CQ_RING);
+            if (cqPtr == nullptr) return false;
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mapRing(sqesSize, IORING_OFF_SQES));
+            if (sqes == nullptr) return false;
+
+            char* sq = static_cast<char*>(sqPtr);
+            sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqEntries = params.sq_entries;
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+            char* cq = static_cast<char*>(cqPtr);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            reaper = std::thread(&UringBackend::reap, this);
+            return true;
+        }
+
+        void submitWrite(AsyncIO::Request* request) override
+        {
+            // Offset -1 = current position, which for an O_APPEND descriptor is the end
+            submit(IORING_OP_WRITE, request->fd,
+                request->data.data() + request->written,
+                (unsigned)(request->data.size() - request->written),
+                (uint64_t)-1, reinterpret_cast<uint64_t>(request));
+        }
+
+        void submitSync(AsyncIO::Request* request) override
+        {
+            submit(IORING_OP_FSYNC, request->fd, nullptr, 0, 0, reinterpret_cast<uint64_t>(request));
+        }
+
+        const char* name() const override { return "io_uring"; }
+
+    private:
+        static const uint64_t WAKE_UP = 0;
+
+        void* mapRing(size_t size, long long offset)
+        {
+            void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+            return ptr == MAP_FAILED ? nullptr : ptr;
+        }
+
+        void submit(uint8_t opcode, int fd, const void* address, unsigned length, uint64_t offset, uint64_t userData)
+        {
+            std::lock_guard<std::mutex> lock(submitMutex);
+
+            // The ring never fills in practice (one request per descriptor), but
+            // if it does, wait for the kernel to consume entries
+            unsigned tail = *sqTail;
+            while (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+            {
+                std::this_thread::yield();
+            }
+
+            unsigned index = tail & sqMask;
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = opcode;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(address);
+            sqe->len = length;
+            sqe->off = offset;
+            sqe->user_data = userData;
+            if (opcode == IORING_OP_FSYNC) sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            sqArray[index] = index;
+
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            while (syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0) < 0 && errno == EINTR)
+            {
+            }
+        }
+
+        void reap()
+        {
+            while (true)
+            {
+                long result = syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (result < 0 && errno != EINTR) break;
+
+                unsigned head = *cqHead;
+                unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+                while (head != tail)
+                {
+                    io_uring_cqe cqe = cqes[head & cqMask];
+                    head++;
+                    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+                    if (cqe.user_data == WAKE_UP) continue;
+                    owner.handleCompletion(reinterpret_cast<AsyncIO::Request*>(cqe.user_data), cqe.res);
+                }
+
+                if (stopping) break;
+            }
+        }
+
+        AsyncIO& owner;
+        int ringFd;
+        void* sqPtr;
+        void* cqPtr;
+        io_uring_sqe* sqes;
+        size_t sqSize;
+        size_t cqSize;
+        size_t sqesSize;
+        unsigned* sqHead;
+        unsigned* sqTail;
+        unsigned sqMask;
+        unsigned sqEntries;
+        unsigned* sqArray;
+        unsigned* cqHead;
+        unsigned* cqTail;
+        unsigned cqMask;
+        io_uring_cqe* cqes;
+        std::mutex submitMutex;
+        std::atomic<bool> stopping;
+        std::thread reaper;
+    };
+#endif
+}
+
+// ==================== ASYNC I/O FRONT END ====================
+
+AsyncIO::AsyncIO(unsigned queueDepth)
+    : nextTicket(1)
+{
+#ifdef ASYNCIO_HAVE_URING
+    std::unique_ptr<UringBackend> uring(new UringBackend(*this));
+    if (uring->init(queueDepth))
+    {
+        backend = std::move(uring);
+    }
+#endif
+    if (!backend)
+    {
+        backend.reset(new ThreadPoolBackend(*this, 2));
+    }
+}
+
+AsyncIO::~AsyncIO()
+{
+    drainAll();
+    backend.reset();
+}
+
+const char* AsyncIO::backendName() const
+{
+    return backend->name();
+}
+
+uint64_t AsyncIO::append(int fd,
+    const std::string& data,
+    bool sync,
+    std::function<void(bool ok)> onComplete)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t ticket = nextTicket++;
+    outstanding.insert(ticket);
+
+    FileQueue& queue = files[fd];
+    if (!queue.pending)
+    {
+        queue.pending.reset(new Request{ fd, std::string(), 0, false, false, {}, {}, {} });
+    }
+
+    // Coalesce with whatever is already waiting behind the in-flight write
+    Request& request = *queue.pending;
+    request.data += data;
+    request.sync = request.sync || sync;
+    request.tickets.push_back(ticket);
+    if (onComplete) request.callbacks.push_back(onComplete);
+    else request.waitable.push_back(ticket);
+
+    if (!queue.inFlight)
+    {
+        startNext(queue);
+    }
+    return ticket;
+}
+
+void AsyncIO::startNext(FileQueue& queue)
+{
+    Request* request = queue.pending.release();
+    queue.inFlight = true;
+    backend->submitWrite(request);
+}
+
+void AsyncIO::handleCompletion(Request* request, long long result)
+{
+    // A write that makes no progress would otherwise be retried forever
+    if (result < 0 || (result == 0 && !request->syncing && request->written < request->data.size()))
+    {
+        finish(request, false);
+        return;
+    }
+
+    if (!request->syncing)
+    {
+        request->written += (size_t)result;
+        if (request->written < request->data.size())
+        {
+            backend->submitWrite(request);     // Short write: send the remainder
+            return;
+        }
+        if (request->sync)
+        {
+            request->syncing = true;
+            backend->submitSync(request);
+            return;
+        }
+    }
+    finish(request, true);
+}
+
+void AsyncIO::finish(Request* request, bool ok)
+{
+    std::unique_ptr<Request> done(request);
+
+    // Callbacks run before the tickets complete, so drain() and wait() only
+    // return once every callback has finished with its owner's state
+    for (const auto& callback : done->callbacks)
+    {
+        callback(ok);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (uint64_t ticket : done->tickets)
+        {
+            outstanding.erase(ticket);
+        }
+
+        // Callbacks already hear about the failure; only tickets that can
+        // only be asked through wait() are remembered
+        if (!ok)
+        {
+            failed.insert(done->waitable.begin(), done->waitable.end());
+        }
+
+        FileQueue& queue = files[done->fd];
+        queue.inFlight = false;
+        if (queue.pending)
+        {
+            startNext(queue);
+        }
+    }
+    completed.notify_all();
+}
+
+bool AsyncIO::wait(uint64_t ticket)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this, ticket] { return outstanding.count(ticket) == 0; });
+
+    // A failure is reported once, then forgotten
+    return failed.erase(ticket) == 0;
+}
+
+void AsyncIO::drain(int fd)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this, fd]
+        {
+            auto it = files.find(fd);
+            return it == files.end() || (!it->second.inFlight && !it->second.pending);
+        });
+}
+
+void AsyncIO::drainAll()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this] { return outstanding.empty(); });
+}
+
+bool AsyncIO::isComplete(uint64_t ticket)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return outstanding.count(ticket) == 0;
+}
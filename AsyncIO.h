@@ -0,0 +1,96 @@
+// ==================== AsyncIO.h ====================
+/**
+ * AsyncIO.h
+ * Asynchronous append-only file writes with completion tracking
+ * On Linux the writes go through io_uring (raw syscalls, no liburing);
+ * elsewhere, or if the kernel refuses io_uring, a small thread pool does
+ * blocking write()/fdatasync() off the caller's thread instead
+ *
+ * Appends to the same file descriptor complete in submission order: only
+ * one write per descriptor is in flight, and anything appended meanwhile is
+ * coalesced into the next write
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+class AsyncIO
+{
+public:
+    AsyncIO(unsigned queueDepth = 64);
+    ~AsyncIO();
+
+    AsyncIO(const AsyncIO&) = delete;
+    AsyncIO& operator=(const AsyncIO&) = delete;
+
+    // 'fd' must be opened for appending (O_APPEND). With 'sync' the data is
+    // fdatasync'd before the ticket completes. 'onComplete' runs on an I/O
+    // thread before the ticket completes, so it must not wait on this AsyncIO
+    uint64_t append(int fd,
+        const std::string& data,
+        bool sync = false,
+        std::function<void(bool ok)> onComplete = nullptr);
+
+    // Block until the ticket (or everything on 'fd', or everything) is done.
+    // wait() reports a ticket's failure only once; tickets appended with a
+    // callback report through the callback instead
+    bool wait(uint64_t ticket);
+    void drain(int fd);
+    void drainAll();
+    bool isComplete(uint64_t ticket);
+
+    const char* backendName() const;
+
+    // One write (plus optional sync) in flight for a descriptor
+    struct Request
+    {
+        int fd;
+        std::string data;
+        size_t written;
+        bool sync;
+        bool syncing;
+        std::vector<uint64_t> tickets;
+        std::vector<std::function<void(bool)>> callbacks;
+        std::vector<uint64_t> waitable;     // Tickets appended without a callback
+    };
+
+    // Executes single operations and reports their raw result (bytes or -errno)
+    class Backend
+    {
+    public:
+        virtual ~Backend() {}
+        virtual void submitWrite(Request* request) = 0;
+        virtual void submitSync(Request* request) = 0;
+        virtual const char* name() const = 0;
+    };
+
+    // Called by backends when an operation finishes
+    void handleCompletion(Request* request, long long result);
+
+private:
+    struct FileQueue
+    {
+        bool inFlight = false;
+        std::unique_ptr<Request> pending;   // Appends waiting for the in-flight write
+    };
+
+    void startNext(FileQueue& queue);
+    void finish(Request* request, bool ok);
+
+    std::mutex mutex;
+    std::condition_variable completed;
+    uint64_t nextTicket;
+    std::unordered_map<int, FileQueue> files;
+    std::unordered_set<uint64_t> outstanding;
+    std::unordered_set<uint64_t> failed;   // Until wait() reports them
+    std::unique_ptr<Backend> backend;
+};
@@ -1,107 +1,140 @@
-// ==================== CSVReader.cpp ====================
-/**
- * CSVReader.cpp
- * Implementation of CSV parsing utilities
- */
-
-#include "CSVReader.h"
-#include <iostream>
-#include <fstream>
-
-CSVReader::CSVReader()
-{
-}
-
-std::vector<OrderBookEntry> CSVReader::readCSV(std::string csvFilename)
-{
-    std::vector<OrderBookEntry> entries;
-    std::ifstream csvFile{ csvFilename };
-    std::string line;
-
-    if (csvFile.is_open())
-    {
-        while (std::getline(csvFile, line))
-        {
-            try {
-                OrderBookEntry obe = stringsToOBE(tokenise(line, ','));
-                entries.push_back(obe);
-            }
-            catch (const std::exception& e)
-            {
-                // Skip invalid lines
-            }
-        }
-    }
-
-    std::cout << "CSVReader::readCSV read " << entries.size() << " entries" << std::endl;
-    return entries;
-}
-
-std::vector<std::string> CSVReader::tokenise(std::string csvLine, char separator)
-{
-    std::vector<std::string> tokens;
-    signed int start, end;
-    std::string token;
-
-    start = csvLine.find_first_not_of(separator, 0);
-    do {
-        end = csvLine.find_first_of(separator, start);
-        if (start == csvLine.length() || start == end) break;
-        if (end >= 0) token = csvLine.substr(start, end - start);
-        else token = csvLine.substr(start, csvLine.length() - start);
-        tokens.push_back(token);
-        start = end + 1;
-    } while (end > 0);
-
-    return tokens;
-}
-
-OrderBookEntry CSVReader::stringsToOBE(std::vector<std::string> tokens)
-{
-    double price, amount;
-
-    if (tokens.size() != 5)
-    {
-        throw std::exception{};
-    }
-
-    try {
-        price = std::stod(tokens[3]);
-        amount = std::stod(tokens[4]);
-    }
-    catch (const std::exception& e) {
-        throw;
-    }
-
-    OrderBookEntry obe{ price,
-                        amount,
-                        tokens[0],
-                        tokens[1],
-                        OrderBookEntry::stringToOrderBookType(tokens[2]) };
-
-    return obe;
-}
-
-OrderBookEntry CSVReader::stringsToOBE(std::string priceString,
-    std::string amountString,
-    std::string timestamp,
-    std::string product,
-    OrderBookType orderType)
-{
-    double price, amount;
-    try {
-        price = std::stod(priceString);
-        amount = std::stod(amountString);
-    }
-    catch (const std::exception& e) {
-        throw;
-    }
-
-    OrderBookEntry obe{ price,
-                    amount,
-                    timestamp,
-                    product,
-                    orderType };
-
-    return obe;
+// ==================== CSVReader.cpp ====================
+/**
+ * CSVReader.cpp
+ * Implementation of CSV parsing utilities
+ */
+
+#include "CSVReader.h"
+#include "CompressedInputStream.h"
+#include <iostream>
+#include <fstream>
+
+CSVReader::CSVReader()
+{
+}
+
+std::vector<OrderBookEntry> CSVReader::readCSV(std::string csvFilename)
+{
+    std::vector<OrderBookEntry> entries;
+
+    // Compressed archives (.gz/.zst) are decompressed on the fly into the same parser
+    if (CompressedInputStream::isCompressed(csvFilename))
+    {
+        if (std::ifstream{ csvFilename }.good())
+        {
+            CompressedInputStream csvFile{ csvFilename };
+            if (csvFile.is_open())
+            {
+                entries = readCSV(csvFile);
+
+                // A missing tool or damaged archive must not pass for a short file
+                if (!csvFile.close())
+                {
+                    std::cout << "CSVReader::readCSV: could not decompress " << csvFilename
+                        << " (missing gzip/zstd or corrupt archive)" << std::endl;
+                    entries.clear();
+                }
+            }
+        }
+    }
+    else
+    {
+        std::ifstream csvFile{ csvFilename };
+        if (csvFile.is_open())
+        {
+            entries = readCSV(csvFile);
+        }
+    }
+
+    std::cout << "CSVReader::readCSV read " << entries.size() << " entries" << std::endl;
+    return entries;
+}
+
+std::vector<OrderBookEntry> CSVReader::readCSV(std::istream& csvStream)
+{
+    std::vector<OrderBookEntry> entries;
+    std::string line;
+
+    while (std::getline(csvStream, line))
+    {
+        try {
+            OrderBookEntry obe = stringsToOBE(tokenise(line, ','));
+            entries.push_back(obe);
+        }
+        catch (const std::exception& e)
+        {
+            // Skip invalid lines
+        }
+    }
+
+    return entries;
+}
+
+std::vector<std::string> CSVReader::tokenise(std::string csvLine, char separator)
+{
+    std::vector<std::string> tokens;
+    signed int start, end;
+    std::string token;
+
+    start = csvLine.find_first_not_of(separator, 0);
+    do {
+        end = csvLine.find_first_of(separator, start);
+        if (start == csvLine.length() || start == end) break;
+        if (end >= 0) token = csvLine.substr(start, end - start);
+        else token = csvLine.substr(start, csvLine.length() - start);
+        tokens.push_back(token);
+        start = end + 1;
+    } while (end > 0);
+
+    return tokens;
+}
+
+OrderBookEntry CSVReader::stringsToOBE(std::vector<std::string> tokens)
+{
+    double price, amount;
+
+    if (tokens.size() != 5)
+    {
+        throw std::exception{};
+    }
+
+    try {
+        price = std::stod(tokens[3]);
+        amount = std::stod(tokens[4]);
+    }
+    catch (const std::exception& e) {
+        throw;
+    }
+
+    OrderBookEntry obe{ price,
+                        amount,
+                        tokens[0],
+                        tokens[1],
+                        OrderBookEntry::stringToOrderBookType(tokens[2]) };
+
+    return obe;
+}
+
+OrderBookEntry CSVReader::stringsToOBE(std::string priceString,
+    std::string amountString,
+    std::string timestamp,
+    std::string product,
+    OrderBookType orderType)
+{
+    double price, amount;
+    try {
+        price = std::stod(priceString);
+        amount = std::stod(amountString);
+    }
+    catch (const std::exception& e) {
+        throw;
+    }
+
+    OrderBookEntry obe{ price,
+                    amount,
+                    timestamp,
+                    product,
+                    orderType };
+
+    return obe;
 }
\ No newline at end of file
@@ -1,28 +1,31 @@
-// ==================== CSVReader.h ====================
-/**
- * CSVReader.h
- * Utility class for parsing CSV files
- */
-
-#pragma once
-#include "OrderBookEntry.h"
-#include <vector>
-#include <string>
-
-class CSVReader
-{
-public:
-    CSVReader();
-
-    static std::vector<OrderBookEntry> readCSV(std::string csvFile);
-    static std::vector<std::string> tokenise(std::string csvLine, char separator);
-
-    static OrderBookEntry stringsToOBE(std::string price,
-        std::string amount,
-        std::string timestamp,
-        std::string product,
-        OrderBookType OrderBookType);
-
-private:
-    static OrderBookEntry stringsToOBE(std::vector<std::string> strings);
-};
+// ==================== CSVReader.h ====================
+/**
+ * CSVReader.h
+ * Utility class for parsing CSV files
+ */
+
+#pragma once
+#include "OrderBookEntry.h"
+#include <vector>
+#include <istream>
+#include <string>
+
+class CSVReader
+{
+public:
+    CSVReader();
+
+    // Accepts plain .csv as well as .csv.gz / .csv.zst (chosen by extension)
+    static std::vector<OrderBookEntry> readCSV(std::string csvFile);
+    static std::vector<OrderBookEntry> readCSV(std::istream& csvStream);
+    static std::vector<std::string> tokenise(std::string csvLine, char separator);
+
+    static OrderBookEntry stringsToOBE(std::string price,
+        std::string amount,
+        std::string timestamp,
+        std::string product,
+        OrderBookType OrderBookType);
+
+private:
+    static OrderBookEntry stringsToOBE(std::vector<std::string> strings);
+};
@@ -0,0 +1,179 @@
+// ==================== CandleInterval.cpp ====================
+/**
+ * CandleInterval.cpp
+ * Implementation of candle interval parsing and bucketing
+ */
+
+#include "CandleInterval.h"
+#include "Timestamp.h"
+#include <cctype>
+
+namespace
+{
+    // Rounds down, also for timestamps before the epoch
+    long long floorDiv(long long value, long long divisor)
+    {
+        long long quotient = value / divisor;
+        if (value % divisor < 0) quotient--;
+        return quotient;
+    }
+
+    // 1970-01-01 was a Thursday; weekly buckets start on Monday 1970-01-05
+    const long long WEEK_OFFSET = 4 * Timestamp::MICROS_PER_DAY;
+}
+
+CandleInterval::CandleInterval()
+    : calendar(false),
+    length(Timestamp::MICROS_PER_DAY)
+{
+}
+
+CandleInterval::CandleInterval(bool _calendar, long long _length)
+    : calendar(_calendar),
+    length(_length)
+{
+}
+
+bool CandleInterval::parse(const std::string& text, CandleInterval& interval)
+{
+    if (text == "daily") interval = CandleInterval(false, Timestamp::MICROS_PER_DAY);
+    else if (text == "monthly") interval = CandleInterval(true, 1);
+    else if (text == "yearly") interval = CandleInterval(true, 12);
+    else
+    {
+        // Count followed by a unit: 500ms, 30s, 5m, 4h, 1d, 1w, 3M, 1y
+        size_t digits = 0;
+        long long count = 0;
+        while (digits < text.size() && std::isdigit((unsigned char)text[digits]))
+        {
+            count = count * 10 + (text[digits] - '0');
+            if (count > 1000000) return false;
+            digits++;
+        }
+        if (digits == 0 || count == 0) return false;
+
+        std::string unit = text.substr(digits);
+        const long long second = Timestamp::MICROS_PER_SECOND;
+
+        if (unit == "ms") interval = CandleInterval(false, count * 1000);
+        else if (unit == "s") interval = CandleInterval(false, count * second);
+        else if (unit == "m") interval = CandleInterval(false, count * 60 * second);
+        else if (unit == "h") interval = CandleInterval(false, count * 3600 * second);
+        else if (unit == "d") interval = CandleInterval(false, count * Timestamp::MICROS_PER_DAY);
+        else if (unit == "w") interval = CandleInterval(false, count * 7 * Timestamp::MICROS_PER_DAY);
+        else if (unit == "M") interval = CandleInterval(true, count);
+        else if (unit == "y") interval = CandleInterval(true, count * 12);
+        else return false;
+    }
+    return true;
+}
+
+const std::vector<CandleInterval>& CandleInterval::standardLevels()
+{
+    const long long second = Timestamp::MICROS_PER_SECOND;
+    static const std::vector<CandleInterval> levels = {
+        CandleInterval(false, second),
+        CandleInterval(false, 60 * second),
+        CandleInterval(false, 5 * 60 * second),
+        CandleInterval(false, 15 * 60 * second),
+        CandleInterval(false, 3600 * second),
+        CandleInterval(false, 4 * 3600 * second),
+        CandleInterval(false, Timestamp::MICROS_PER_DAY),
+        CandleInterval(true, 1),
+        CandleInterval(true, 12)
+    };
+    return levels;
+}
+
+long long CandleInterval::bucketStart(long long micros) const
+{
+    if (!calendar)
+    {
+        long long offset = alignment();
+        return floorDiv(micros - offset, length) * length + offset;
+    }
+
+    int year;
+    unsigned month, day;
+    Timestamp::toDate(micros, year, month, day);
+    long long monthIndex = floorDiv((long long)year * 12 + (month - 1), length) * length;
+    long long startYear = floorDiv(monthIndex, 12);
+    return Timestamp::fromDate((int)startYear, (unsigned)(monthIndex - startYear * 12) + 1, 1);
+}
+
+long long CandleInterval::bucketEnd(long long start) const
+{
+    if (!calendar)
+    {
+        return start + length;
+    }
+
+    int year;
+    unsigned month, day;
+    Timestamp::toDate(start, year, month, day);
+    long long monthIndex = (long long)year * 12 + (month - 1) + length;
+    long long endYear = floorDiv(monthIndex, 12);
+    return Timestamp::fromDate((int)endYear, (unsigned)(monthIndex - endYear * 12) + 1, 1);
+}
+
+std::string CandleInterval::label(long long start) const
+{
+    // "2020/03/17 17:01:24.884492" -> "2020-03-17 17:01:24.884492", then cut to precision
+    std::string text = Timestamp::fromMicros(start);
+    text[4] = '-';
+    text[7] = '-';
+
+    size_t keep;
+    if (calendar) keep = (length % 12 == 0) ? 4 : 7;
+    else if (length % Timestamp::MICROS_PER_DAY == 0) keep = 10;
+    else if (length % (60 * Timestamp::MICROS_PER_SECOND) == 0) keep = 16;
+    else if (length % Timestamp::MICROS_PER_SECOND == 0) keep = 19;
+    else keep = text.size();
+
+    return text.substr(0, keep);
+}
+
+std::string CandleInterval::toString() const
+{
+    const long long second = Timestamp::MICROS_PER_SECOND;
+
+    if (calendar)
+    {
+        return (length % 12 == 0) ? std::to_string(length / 12) + "y" : std::to_string(length) + "M";
+    }
+    if (length % (7 * Timestamp::MICROS_PER_DAY) == 0) return std::to_string(length / (7 * Timestamp::MICROS_PER_DAY)) + "w";
+    if (length % Timestamp::MICROS_PER_DAY == 0) return std::to_string(length / Timestamp::MICROS_PER_DAY) + "d";
+    if (length % (3600 * second) == 0) return std::to_string(length / (3600 * second)) + "h";
+    if (length % (60 * second) == 0) return std::to_string(length / (60 * second)) + "m";
+    if (length % second == 0) return std::to_string(length / second) + "s";
+    return std::to_string(length / 1000) + "ms";
+}
+
+bool CandleInterval::divides(const CandleInterval& coarser) const
+{
+    if (calendar)
+    {
+        return coarser.calendar && coarser.length % length == 0;
+    }
+    if (coarser.calendar)
+    {
+        // Months start at midnight, so any length that divides a day nests
+        return Timestamp::MICROS_PER_DAY % length == 0;
+    }
+
+    // Both lengths nest, and the coarser buckets (weeks start on Monday)
+    // begin on a boundary of this interval
+    return coarser.length % length == 0 &&
+        (coarser.alignment() - alignment()) % length == 0;
+}
+
+long long CandleInterval::alignment() const
+{
+    return (!calendar && length % (7 * Timestamp::MICROS_PER_DAY) == 0) ? WEEK_OFFSET : 0;
+}
+
+bool CandleInterval::operator<(const CandleInterval& other) const
+{
+    if (calendar != other.calendar) return !calendar;
+    return length < other.length;
+}
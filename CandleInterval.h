@@ -0,0 +1,51 @@
+// ==================== CandleInterval.h ====================
+/**
+ * CandleInterval.h
+ * Candle bucket size over integer timestamps
+ * Fixed lengths ("1s", "5m", "1h", "1d", "1w") bucket by integer division
+ * from the epoch; months and years ("1M", "1y") follow the calendar.
+ * "daily", "monthly" and "yearly" are accepted as aliases
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+
+class CandleInterval
+{
+public:
+    CandleInterval();  // One day
+
+    // Returns false if the text is not a valid interval
+    static bool parse(const std::string& text, CandleInterval& interval);
+
+    // Levels kept by CandlestickPyramid, finest first
+    static const std::vector<CandleInterval>& standardLevels();
+
+    long long bucketStart(long long micros) const;
+    long long bucketEnd(long long start) const;   // Start of the next bucket
+
+    // Date label for a bucket, e.g. "2020-03-17 17:05" for minute buckets
+    std::string label(long long start) const;
+
+    std::string toString() const;
+
+    // True if every bucket of 'coarser' is made of whole buckets of this one
+    bool divides(const CandleInterval& coarser) const;
+
+    bool operator==(const CandleInterval& other) const
+    {
+        return calendar == other.calendar && length == other.length;
+    }
+    bool operator!=(const CandleInterval& other) const { return !(*this == other); }
+    bool operator<(const CandleInterval& other) const;
+
+private:
+    CandleInterval(bool _calendar, long long _length);
+
+    // Where fixed-length buckets are counted from: Monday for whole weeks
+    long long alignment() const;
+
+    bool calendar;      // Length counts months instead of microseconds
+    long long length;
+};
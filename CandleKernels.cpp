@@ -0,0 +1,103 @@
+// ==================== CandleKernels.cpp ====================
+/**
+ * CandleKernels.cpp
+ * Implementation of the fused candle reductions
+ */
+
+#include "CandleKernels.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CANDLE_KERNELS_SSE2
+#endif
+
+CandleKernels::Summary CandleKernels::summarize(const double* prices, const double* amounts, size_t count)
+{
+    double low = prices[0];
+    double high = prices[0];
+    double volume = 0.0;
+    double notional = 0.0;
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if (count >= 4)
+    {
+        __m256d vLow = _mm256_loadu_pd(prices);
+        __m256d vHigh = vLow;
+        __m256d vVolume = _mm256_setzero_pd();
+        __m256d vNotional = _mm256_setzero_pd();
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256d p = _mm256_loadu_pd(prices + i);
+            __m256d a = _mm256_loadu_pd(amounts + i);
+            vLow = _mm256_min_pd(vLow, p);
+            vHigh = _mm256_max_pd(vHigh, p);
+            vVolume = _mm256_add_pd(vVolume, a);
+            vNotional = _mm256_add_pd(vNotional, _mm256_mul_pd(p, a));
+        }
+
+        double lanes[4];
+        _mm256_storeu_pd(lanes, vLow);
+        for (double v : lanes) if (v < low) low = v;
+        _mm256_storeu_pd(lanes, vHigh);
+        for (double v : lanes) if (v > high) high = v;
+        _mm256_storeu_pd(lanes, vVolume);
+        volume = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        _mm256_storeu_pd(lanes, vNotional);
+        notional = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#elif defined(CANDLE_KERNELS_SSE2)
+    if (count >= 2)
+    {
+        __m128d vLow = _mm_loadu_pd(prices);
+        __m128d vHigh = vLow;
+        __m128d vVolume = _mm_setzero_pd();
+        __m128d vNotional = _mm_setzero_pd();
+
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128d p = _mm_loadu_pd(prices + i);
+            __m128d a = _mm_loadu_pd(amounts + i);
+            vLow = _mm_min_pd(vLow, p);
+            vHigh = _mm_max_pd(vHigh, p);
+            vVolume = _mm_add_pd(vVolume, a);
+            vNotional = _mm_add_pd(vNotional, _mm_mul_pd(p, a));
+        }
+
+        double lanes[2];
+        _mm_storeu_pd(lanes, vLow);
+        low = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+        _mm_storeu_pd(lanes, vHigh);
+        high = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+        _mm_storeu_pd(lanes, vVolume);
+        volume = lanes[0] + lanes[1];
+        _mm_storeu_pd(lanes, vNotional);
+        notional = lanes[0] + lanes[1];
+    }
+#endif
+
+    // Remaining elements (all of them without SIMD)
+    for (; i < count; i++)
+    {
+        if (prices[i] < low) low = prices[i];
+        if (prices[i] > high) high = prices[i];
+        volume += amounts[i];
+        notional += prices[i] * amounts[i];
+    }
+
+    return Summary{ low, high, volume, notional };
+}
+
+const char* CandleKernels::instructionSet()
+{
+#if defined(__AVX__)
+    return "avx";
+#elif defined(CANDLE_KERNELS_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,28 @@
+// ==================== CandleKernels.h ====================
+/**
+ * CandleKernels.h
+ * Vectorised reductions over columnar price/amount arrays
+ * TASK 1: One fused pass yields low, high, volume and price * amount for a
+ * bucket. Uses AVX or SSE2 when the compiler targets them, else scalar code
+ */
+
+#pragma once
+#include <cstddef>
+
+class CandleKernels
+{
+public:
+    struct Summary
+    {
+        double low;
+        double high;
+        double volume;     // Sum of amounts
+        double notional;   // Sum of price * amount
+    };
+
+    // 'count' must be at least 1
+    static Summary summarize(const double* prices, const double* amounts, size_t count);
+
+    // Name of the instruction set summarize() was compiled for
+    static const char* instructionSet();
+};
@@ -0,0 +1,68 @@
+// ==================== CandleSeries.cpp ====================
+/**
+ * CandleSeries.cpp
+ * Implementation of the columnar candle series
+ */
+
+#include "CandleSeries.h"
+
+CandleSeries::CandleSeries(std::string _product,
+    OrderBookType _type,
+    CandleInterval _interval)
+    : product(_product),
+    type(_type),
+    interval(_interval)
+{
+}
+
+CandleSeries::CandleSeries()
+    : product(""),
+    type(OrderBookType::unknown),
+    interval()
+{
+}
+
+void CandleSeries::reserve(size_t count)
+{
+    starts.reserve(count);
+    opens.reserve(count);
+    highs.reserve(count);
+    lows.reserve(count);
+    closes.reserve(count);
+    volumes.reserve(count);
+    trades.reserve(count);
+    vwaps.reserve(count);
+}
+
+void CandleSeries::setRow(size_t index, long long start, double open, double high, double low,
+    double close, double volume, long long tradeCount, double vwap)
+{
+    if (index == starts.size())
+    {
+        starts.push_back(start);
+        opens.push_back(open);
+        highs.push_back(high);
+        lows.push_back(low);
+        closes.push_back(close);
+        volumes.push_back(volume);
+        trades.push_back(tradeCount);
+        vwaps.push_back(vwap);
+        return;
+    }
+
+    starts[index] = start;
+    opens[index] = open;
+    highs[index] = high;
+    lows[index] = low;
+    closes[index] = close;
+    volumes[index] = volume;
+    trades[index] = tradeCount;
+    vwaps[index] = vwap;
+}
+
+Candlestick CandleSeries::at(size_t index) const
+{
+    std::string typeStr = (type == OrderBookType::ask) ? "ask" : "bid";
+    return Candlestick(getDate(index), opens[index], highs[index], lows[index], closes[index],
+        volumes[index], trades[index], vwaps[index], product, typeStr);
+}
@@ -0,0 +1,73 @@
+// ==================== CandleSeries.h ====================
+/**
+ * CandleSeries.h
+ * Columnar candle history for one product, side and interval
+ * TASK 1: Bucket starts are int64 microseconds and each field is its own
+ * array; product, side and interval are stored once per series instead of
+ * once per candle. Date labels are formatted only when displayed
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "Candlestick.h"
+#include "CandleInterval.h"
+#include "OrderBookEntry.h"
+
+class CandleSeries
+{
+public:
+    CandleSeries(std::string _product,
+        OrderBookType _type,
+        CandleInterval _interval);
+
+    CandleSeries();
+
+    size_t size() const { return starts.size(); }
+    bool empty() const { return starts.empty(); }
+    void reserve(size_t count);
+
+    // Writes row 'index'; index == size() appends
+    void setRow(size_t index, long long start, double open, double high, double low,
+        double close, double volume, long long trades, double vwap);
+
+    const std::string& getProduct() const { return product; }
+    OrderBookType getType() const { return type; }
+    const CandleInterval& getInterval() const { return interval; }
+
+    // Per-candle access
+    std::string getDate(size_t index) const { return interval.label(starts[index]); }
+    long long getStart(size_t index) const { return starts[index]; }
+    double getOpen(size_t index) const { return opens[index]; }
+    double getHigh(size_t index) const { return highs[index]; }
+    double getLow(size_t index) const { return lows[index]; }
+    double getClose(size_t index) const { return closes[index]; }
+    double getVolume(size_t index) const { return volumes[index]; }
+    long long getTrades(size_t index) const { return trades[index]; }
+    double getVWAP(size_t index) const { return vwaps[index]; }
+
+    // Row view as a standalone Candlestick
+    Candlestick at(size_t index) const;
+
+    // Whole columns, for vectorised analysis
+    const std::vector<long long>& getStarts() const { return starts; }
+    const std::vector<double>& getOpens() const { return opens; }
+    const std::vector<double>& getHighs() const { return highs; }
+    const std::vector<double>& getLows() const { return lows; }
+    const std::vector<double>& getCloses() const { return closes; }
+    const std::vector<double>& getVolumes() const { return volumes; }
+
+private:
+    std::string product;
+    OrderBookType type;
+    CandleInterval interval;
+
+    std::vector<long long> starts;   // Bucket start, microseconds
+    std::vector<double> opens;
+    std::vector<double> highs;
+    std::vector<double> lows;
+    std::vector<double> closes;
+    std::vector<double> volumes;
+    std::vector<long long> trades;
+    std::vector<double> vwaps;
+};
@@ -0,0 +1,164 @@
+// ==================== CandlestickAggregator.cpp ====================
+/**
+ * CandlestickAggregator.cpp
+ * Implementation of streaming candlestick aggregation
+ */
+
+#include "CandlestickAggregator.h"
+#include "Timestamp.h"
+#include "CandleKernels.h"
+#include <algorithm>
+
+CandlestickAggregator::CandlestickAggregator(std::string _product,
+    OrderBookType _type,
+    CandleInterval _interval)
+    : product(_product),
+    type(_type),
+    interval(_interval),
+    current(),
+    hasCurrent(false)
+{
+}
+
+void CandlestickAggregator::addOrder(const OrderBookEntry& order)
+{
+    if (order.product != product || order.orderType != type) return;
+
+    long long micros = Timestamp::toMicros(order.timestamp);
+    if (micros >= 0)
+    {
+        addPrice(micros, order.price, order.amount);
+    }
+}
+
+CandlestickAggregator::AddResult CandlestickAggregator::addPrice(long long micros, double price, double amount)
+{
+    return addCandle(Bucket{ micros, price, price, price, price, amount, price * amount, 1 });
+}
+
+void CandlestickAggregator::addColumns(const long long* times, const double* prices,
+    const double* amounts, size_t count)
+{
+    size_t first = 0;
+    while (first < count)
+    {
+        // Extent of the run of ticks that fall in the same bucket
+        long long start = interval.bucketStart(times[first]);
+        long long end = interval.bucketEnd(start);
+        size_t last = first + 1;
+        while (last < count && times[last] >= start && times[last] < end)
+        {
+            last++;
+        }
+
+        CandleKernels::Summary summary = CandleKernels::summarize(prices + first, amounts + first, last - first);
+        addCandle(Bucket{ start, prices[first], summary.high, summary.low, prices[last - 1],
+            summary.volume, summary.notional, (long long)(last - first) });
+        first = last;
+    }
+}
+
+CandlestickAggregator::AddResult CandlestickAggregator::addCandle(const Bucket& candle)
+{
+    long long start = interval.bucketStart(candle.start);
+
+    if (hasCurrent && start == current.start)
+    {
+        merge(current, candle);
+        return AddResult::merged;
+    }
+
+    if (!hasCurrent || start > current.start)
+    {
+        // A new bucket has started: close the current candle
+        bool closing = hasCurrent;
+        if (closing)
+        {
+            closed.push_back(current);
+        }
+        current = candle;
+        current.start = start;
+        hasCurrent = true;
+        return closing ? AddResult::closed : AddResult::merged;
+    }
+
+    addLate(candle);
+    return AddResult::late;
+}
+
+void CandlestickAggregator::addLate(const Bucket& candle)
+{
+    long long start = interval.bucketStart(candle.start);
+    Bucket* target = nullptr;
+
+    if (hasCurrent && start == current.start)
+    {
+        target = &current;
+    }
+    else
+    {
+        auto it = std::lower_bound(closed.begin(), closed.end(), start,
+            [](const Bucket& bucket, long long key) { return bucket.start < key; });
+
+        if (it == closed.end() || it->start != start)
+        {
+            Bucket bucket = candle;
+            bucket.start = start;
+            closed.insert(it, bucket);
+            return;
+        }
+        target = &*it;
+    }
+
+    // Extend the range but keep open/close: in-order data already set them
+    if (candle.high > target->high) target->high = candle.high;
+    if (candle.low < target->low) target->low = candle.low;
+    target->volume += candle.volume;
+    target->notional += candle.notional;
+    target->trades += candle.trades;
+}
+
+std::vector<CandlestickAggregator::Bucket> CandlestickAggregator::getBuckets() const
+{
+    std::vector<Bucket> buckets;
+    buckets.reserve(closed.size() + 1);
+    buckets.insert(buckets.end(), closed.begin(), closed.end());
+    if (hasCurrent)
+    {
+        buckets.push_back(current);
+    }
+    return buckets;
+}
+
+CandleSeries CandlestickAggregator::getSeries() const
+{
+    return toSeries(getBuckets());
+}
+
+CandleSeries CandlestickAggregator::toSeries(const std::vector<Bucket>& buckets) const
+{
+    CandleSeries series(product, type, interval);
+    series.reserve(buckets.size());
+    for (const Bucket& bucket : buckets)
+    {
+        writeRow(series, series.size(), bucket);
+    }
+    return series;
+}
+
+void CandlestickAggregator::writeRow(CandleSeries& series, size_t index, const Bucket& bucket)
+{
+    double vwap = (bucket.volume > 0.0) ? bucket.notional / bucket.volume : bucket.close;
+    series.setRow(index, bucket.start, bucket.open, bucket.high, bucket.low, bucket.close,
+        bucket.volume, bucket.trades, vwap);
+}
+
+void CandlestickAggregator::merge(Bucket& target, const Bucket& later)
+{
+    if (later.high > target.high) target.high = later.high;
+    if (later.low < target.low) target.low = later.low;
+    target.close = later.close;
+    target.volume += later.volume;
+    target.notional += later.notional;
+    target.trades += later.trades;
+}
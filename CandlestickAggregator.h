@@ -0,0 +1,84 @@
+// ==================== CandlestickAggregator.h ====================
+/**
+ * CandlestickAggregator.h
+ * Streaming OHLC aggregation for one product, order side and interval
+ * TASK 1: Each order updates the open/high/low/close of its bucket in O(1);
+ * once a later bucket starts, the previous candle is closed.
+ * Orders are never copied or re-scanned
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "CandleSeries.h"
+#include "OrderBookEntry.h"
+
+class CandlestickAggregator
+{
+public:
+    // One candle; 'start' is the bucket start in microseconds
+    struct Bucket
+    {
+        long long start;
+        double open;
+        double high;
+        double low;
+        double close;
+        double volume;     // Sum of amounts
+        double notional;   // Sum of price * amount, for VWAP
+        long long trades;
+    };
+
+    enum class AddResult
+    {
+        merged,   // Went into the open candle
+        closed,   // Started a new candle; the previous one is getClosed().back()
+        late      // Belonged to an already closed candle
+    };
+
+    CandlestickAggregator(std::string _product,
+        OrderBookType _type,
+        CandleInterval _interval);
+
+    // Orders for other products or sides are ignored
+    void addOrder(const OrderBookEntry& order);
+    AddResult addPrice(long long micros, double price, double amount);
+
+    // Adds time-ordered columns of ticks: each bucket's run is reduced in one
+    // fused vectorised pass instead of tick by tick
+    void addColumns(const long long* times, const double* prices, const double* amounts, size_t count);
+
+    // Merges a finer candle whose start lies in this interval's bucket
+    AddResult addCandle(const Bucket& candle);
+
+    // Widens high/low and adds the volume of the bucket containing
+    // 'candle.start' without touching open/close (used for out-of-order data)
+    void addLate(const Bucket& candle);
+
+    const CandleInterval& getInterval() const { return interval; }
+    const std::vector<Bucket>& getClosed() const { return closed; }
+    bool hasOpenCandle() const { return hasCurrent; }
+    const Bucket& getOpen() const { return current; }
+
+    // Closed candles followed by the still-open one, oldest first
+    std::vector<Bucket> getBuckets() const;
+    CandleSeries getSeries() const;
+
+    // Buckets of this product, side and interval as a series
+    CandleSeries toSeries(const std::vector<Bucket>& buckets) const;
+
+    // Writes a bucket as row 'index' of a series (index == size() appends)
+    static void writeRow(CandleSeries& series, size_t index, const Bucket& bucket);
+
+    // Appends 'later' to 'target': open stays, close moves on, volumes add
+    static void merge(Bucket& target, const Bucket& later);
+
+private:
+    std::string product;
+    OrderBookType type;
+    CandleInterval interval;
+
+    Bucket current;
+    bool hasCurrent;
+    std::vector<Bucket> closed;   // Sorted by start
+};
@@ -0,0 +1,227 @@
+// ==================== CandlestickBatch.cpp ====================
+/**
+ * CandlestickBatch.cpp
+ * Implementation of parallel bulk candle generation
+ */
+
+#include "CandlestickBatch.h"
+#include "CandlestickAggregator.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    typedef std::vector<CandlestickAggregator::Bucket> Buckets;
+
+    // Below this many orders per chunk, extra threads cost more than they save
+    const size_t MIN_CHUNK = 16384;
+
+    struct Columns
+    {
+        std::vector<long long> times;
+        std::vector<double> prices;
+        std::vector<double> amounts;
+    };
+
+    // One chunk's share of a product and side: its ticks, then its candles
+    // for each interval
+    struct Partial
+    {
+        Columns columns;
+        std::vector<Buckets> candles;
+    };
+
+    struct Chunk
+    {
+        std::unordered_map<std::string, size_t> keys;   // "product|side" -> index
+        std::vector<Partial> partials;
+    };
+
+    std::string sideName(OrderBookType type)
+    {
+        return type == OrderBookType::ask ? "ask" : "bid";
+    }
+
+    // For each interval (sorted finest first), the finer interval it can be
+    // rolled up from, or -1 to build it from the ticks
+    std::vector<int> rollupSources(const std::vector<CandleInterval>& intervals)
+    {
+        std::vector<int> sources(intervals.size(), -1);
+        for (size_t i = 0; i < intervals.size(); i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                if (intervals[j].divides(intervals[i]))
+                {
+                    sources[i] = (int)j;
+                }
+            }
+        }
+        return sources;
+    }
+
+    void buildPartial(Partial& partial, const std::string& product, OrderBookType type,
+        const std::vector<CandleInterval>& intervals, const std::vector<int>& sources)
+    {
+        partial.candles.resize(intervals.size());
+        for (size_t i = 0; i < intervals.size(); i++)
+        {
+            CandlestickAggregator aggregator(product, type, intervals[i]);
+            if (sources[i] < 0)
+            {
+                const Columns& c = partial.columns;
+                aggregator.addColumns(c.times.data(), c.prices.data(), c.amounts.data(), c.times.size());
+            }
+            else
+            {
+                for (const CandlestickAggregator::Bucket& bucket : partial.candles[sources[i]])
+                {
+                    aggregator.addCandle(bucket);
+                }
+            }
+            partial.candles[i] = aggregator.getBuckets();
+        }
+
+        // The ticks are no longer needed once the candles exist
+        partial.columns = Columns();
+    }
+
+    template <typename Work>
+    void runWorkers(unsigned threads, Work work)
+    {
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++)
+        {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
+
+std::vector<CandleSeries> CandlestickBatch::generateAll(const std::vector<OrderBookEntry>& orders,
+    const std::vector<std::string>& intervalNames,
+    unsigned threads)
+{
+    // Parse intervals; work finest first so coarser ones can be rolled up
+    std::vector<CandleInterval> requested;
+    for (const std::string& name : intervalNames)
+    {
+        CandleInterval interval;
+        if (CandleInterval::parse(name, interval))
+        {
+            requested.push_back(interval);
+        }
+        else
+        {
+            std::cout << "CandlestickBatch::generateAll: unknown interval " << name << std::endl;
+        }
+    }
+    std::vector<CandleInterval> intervals = requested;
+    std::sort(intervals.begin(), intervals.end());
+    intervals.erase(std::unique(intervals.begin(), intervals.end()), intervals.end());
+    std::vector<int> sources = rollupSources(intervals);
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads, orders.size() / MIN_CHUNK));
+    std::vector<Chunk> chunks(chunkCount);
+
+    // ===== Phase 1: each worker parses its chunk and builds partial candles =====
+    runWorkers((unsigned)chunkCount, [&](unsigned index)
+    {
+        Chunk& chunk = chunks[index];
+        size_t begin = orders.size() * index / chunkCount;
+        size_t end = orders.size() * (index + 1) / chunkCount;
+
+        const OrderBookEntry* lastOrder = nullptr;
+        Partial* partial = nullptr;
+        for (size_t i = begin; i < end; i++)
+        {
+            const OrderBookEntry& order = orders[i];
+            if (order.orderType != OrderBookType::ask && order.orderType != OrderBookType::bid) continue;
+
+            long long micros = Timestamp::toMicros(order.timestamp);
+            if (micros < 0) continue;
+
+            // Consecutive orders usually share a product and side
+            if (!lastOrder || lastOrder->product != order.product || lastOrder->orderType != order.orderType)
+            {
+                std::string key = order.product + "|" + sideName(order.orderType);
+                auto found = chunk.keys.emplace(key, chunk.partials.size());
+                if (found.second)
+                {
+                    chunk.partials.emplace_back();
+                }
+                partial = &chunk.partials[found.first->second];
+                lastOrder = &order;
+            }
+
+            partial->columns.times.push_back(micros);
+            partial->columns.prices.push_back(order.price);
+            partial->columns.amounts.push_back(order.amount);
+        }
+
+        for (const auto& key : chunk.keys)
+        {
+            size_t split = key.first.rfind('|');
+            OrderBookType type = OrderBookEntry::stringToOrderBookType(key.first.substr(split + 1));
+            buildPartial(chunk.partials[key.second], key.first.substr(0, split), type, intervals, sources);
+        }
+    });
+
+    // ===== Phase 2: join each key's partial candles across chunk boundaries =====
+    std::map<std::string, std::pair<std::string, OrderBookType>> keys;   // Sorted output order
+    for (const Chunk& chunk : chunks)
+    {
+        for (const auto& key : chunk.keys)
+        {
+            size_t split = key.first.rfind('|');
+            keys[key.first] = { key.first.substr(0, split),
+                OrderBookEntry::stringToOrderBookType(key.first.substr(split + 1)) };
+        }
+    }
+
+    std::vector<std::pair<std::string, std::pair<std::string, OrderBookType>>> jobs(keys.begin(), keys.end());
+    std::vector<CandleSeries> results(jobs.size() * requested.size());
+    std::atomic<size_t> nextJob(0);
+
+    runWorkers((unsigned)std::min<size_t>(threads, std::max<size_t>(1, jobs.size())), [&](unsigned)
+    {
+        for (size_t job = nextJob++; job < jobs.size(); job = nextJob++)
+        {
+            const std::string& product = jobs[job].second.first;
+            OrderBookType type = jobs[job].second.second;
+
+            for (size_t r = 0; r < requested.size(); r++)
+            {
+                size_t level = std::lower_bound(intervals.begin(), intervals.end(), requested[r]) - intervals.begin();
+
+                // Chunks are in order, so a bucket split by a boundary merges back
+                CandlestickAggregator joined(product, type, requested[r]);
+                for (const Chunk& chunk : chunks)
+                {
+                    auto found = chunk.keys.find(jobs[job].first);
+                    if (found == chunk.keys.end()) continue;
+                    for (const CandlestickAggregator::Bucket& bucket : chunk.partials[found->second].candles[level])
+                    {
+                        joined.addCandle(bucket);
+                    }
+                }
+                results[job * requested.size() + r] = joined.getSeries();
+            }
+        }
+    });
+
+    return results;
+}
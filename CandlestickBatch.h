@@ -0,0 +1,26 @@
+// ==================== CandlestickBatch.h ====================
+/**
+ * CandlestickBatch.h
+ * Candle series for every product, side and interval at once
+ * TASK 1: The orders are split into contiguous chunks, one per worker
+ * thread. Each worker parses its chunk once into per-product columns and
+ * builds partial candles; a second parallel phase joins the partial
+ * candles at the chunk boundaries
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "CandleSeries.h"
+#include "OrderBookEntry.h"
+
+class CandlestickBatch
+{
+public:
+    // One series per product x side (ask, bid) x interval, ordered by
+    // product, then side, then the order of 'intervals'. Unknown intervals
+    // are skipped. threads == 0 uses every core
+    static std::vector<CandleSeries> generateAll(const std::vector<OrderBookEntry>& orders,
+        const std::vector<std::string>& intervals,
+        unsigned threads = 0);
+};
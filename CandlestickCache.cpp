@@ -0,0 +1,172 @@
+// ==================== CandlestickCache.cpp ====================
+/**
+ * CandlestickCache.cpp
+ * Implementation of the candle series cache
+ */
+
+#include "CandlestickCache.h"
+#include "Timestamp.h"
+#include <mutex>
+
+std::string CandlestickCache::makeKey(const std::string& product, OrderBookType type)
+{
+    return product + "|" + (type == OrderBookType::ask ? "ask" : "bid");
+}
+
+CandleSeries CandlestickCache::getSeries(const std::string& product,
+    const CandleInterval& interval,
+    OrderBookType type,
+    const Loader& load)
+{
+    if (!CandlestickPyramid::supports(interval))
+    {
+        return CandleSeries(product, type, interval);
+    }
+
+    std::string key = makeKey(product, type);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        Series* series = find(key, interval);
+        if (series != nullptr)
+        {
+            return series->candles;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return findOrBuild(key, product, interval, type, load).candles;
+}
+
+IndicatorEngine CandlestickCache::getIndicators(const std::string& product,
+    const CandleInterval& interval,
+    OrderBookType type,
+    const Loader& load)
+{
+    if (!CandlestickPyramid::supports(interval))
+    {
+        return IndicatorEngine::standard();
+    }
+
+    std::string key = makeKey(product, type);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        Series* series = find(key, interval);
+        if (series != nullptr)
+        {
+            return withOpenCandle(*series);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return withOpenCandle(findOrBuild(key, product, interval, type, load));
+}
+
+CandlestickCache::Series* CandlestickCache::find(const std::string& key, const CandleInterval& interval)
+{
+    auto entry = entries.find(key);
+    if (entry == entries.end())
+    {
+        return nullptr;
+    }
+
+    auto series = entry->second.series.find(interval);
+    return series != entry->second.series.end() ? &series->second : nullptr;
+}
+
+CandlestickCache::Series& CandlestickCache::findOrBuild(const std::string& key,
+    const std::string& product,
+    const CandleInterval& interval,
+    OrderBookType type,
+    const Loader& load)
+{
+    auto entry = entries.find(key);
+    if (entry == entries.end())
+    {
+        Entry created{ CandlestickPyramid(product, type), {} };
+        load(created.pyramid);
+        entry = entries.emplace(key, std::move(created)).first;
+    }
+
+    auto series = entry->second.series.find(interval);
+    if (series == entry->second.series.end())
+    {
+        // Built from the pyramid's candles, not from the orders
+        Series created{ CandlestickAggregator(product, type, interval), CandleSeries(), IndicatorEngine() };
+        for (const CandlestickAggregator::Bucket& bucket : entry->second.pyramid.getBuckets(interval))
+        {
+            created.aggregator.addCandle(bucket);
+        }
+        created.candles = created.aggregator.getSeries();
+        resetIndicators(created);
+        series = entry->second.series.emplace(interval, std::move(created)).first;
+    }
+    return series->second;
+}
+
+void CandlestickCache::addOrder(const OrderBookEntry& order)
+{
+    if (order.orderType != OrderBookType::ask && order.orderType != OrderBookType::bid) return;
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto entry = entries.find(makeKey(order.product, order.orderType));
+    if (entry == entries.end()) return;
+
+    long long micros = Timestamp::toMicros(order.timestamp);
+    if (micros < 0) return;
+
+    entry->second.pyramid.addPrice(micros, order.price, order.amount);
+    for (auto& series : entry->second.series)
+    {
+        update(series.second, micros, order.price, order.amount);
+    }
+}
+
+void CandlestickCache::update(Series& series, long long micros, double price, double amount)
+{
+    typedef CandlestickAggregator::AddResult AddResult;
+    CandlestickAggregator& aggregator = series.aggregator;
+
+    AddResult result = aggregator.addPrice(micros, price, amount);
+    if (result == AddResult::late || series.candles.empty())
+    {
+        // An earlier candle changed: rare, so rebuild the whole series
+        series.candles = aggregator.getSeries();
+        resetIndicators(series);
+        return;
+    }
+
+    // Only the trailing candles change: the one just closed and the open one
+    if (result == AddResult::closed)
+    {
+        const CandlestickAggregator::Bucket& closed = aggregator.getClosed().back();
+        size_t last = series.candles.size() - 1;
+        CandlestickAggregator::writeRow(series.candles, last, closed);
+        CandlestickAggregator::writeRow(series.candles, last + 1, aggregator.getOpen());
+        series.indicators.update(closed.high, closed.low, closed.close);
+    }
+    else
+    {
+        CandlestickAggregator::writeRow(series.candles, series.candles.size() - 1, aggregator.getOpen());
+    }
+}
+
+void CandlestickCache::resetIndicators(Series& series)
+{
+    series.indicators = IndicatorEngine::standard();
+    for (const CandlestickAggregator::Bucket& bucket : series.aggregator.getClosed())
+    {
+        series.indicators.update(bucket.high, bucket.low, bucket.close);
+    }
+}
+
+IndicatorEngine CandlestickCache::withOpenCandle(const Series& series)
+{
+    // The open candle may still change, so it only goes into a copy
+    IndicatorEngine indicators = series.indicators;
+    if (series.aggregator.hasOpenCandle())
+    {
+        const CandlestickAggregator::Bucket& open = series.aggregator.getOpen();
+        indicators.update(open.high, open.low, open.close);
+    }
+    return indicators;
+}
@@ -0,0 +1,70 @@
+// ==================== CandlestickCache.h ====================
+/**
+ * CandlestickCache.h
+ * Computed candle series kept in memory per (product, interval, side)
+ * TASK 1: A series is built once from the product's pyramid, then each new
+ * order only updates the trailing candle of the cached series for that
+ * product and side, and each closed candle advances the series' indicators.
+ * Safe to query from several threads
+ */
+
+#pragma once
+#include <functional>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "CandlestickPyramid.h"
+#include "IndicatorEngine.h"
+
+class CandlestickCache
+{
+public:
+    // Feeds every order known so far into a new pyramid
+    typedef std::function<void(CandlestickPyramid&)> Loader;
+
+    // Served from memory after the first request for the key; returns an
+    // empty series for intervals the pyramid cannot build
+    CandleSeries getSeries(const std::string& product,
+        const CandleInterval& interval,
+        OrderBookType type,
+        const Loader& load);
+
+    // The standard indicators of the same series, advanced by its open
+    // candle; costs O(1) per indicator however long the series is
+    IndicatorEngine getIndicators(const std::string& product,
+        const CandleInterval& interval,
+        OrderBookType type,
+        const Loader& load);
+
+    // Updates the pyramid and cached series of the order's product and side
+    void addOrder(const OrderBookEntry& order);
+
+private:
+    struct Series
+    {
+        CandlestickAggregator aggregator;
+        CandleSeries candles;   // Aggregator output, patched in place
+        IndicatorEngine indicators;   // Fed each candle as it closes
+    };
+
+    struct Entry
+    {
+        CandlestickPyramid pyramid;
+        std::map<CandleInterval, Series> series;
+    };
+
+    static std::string makeKey(const std::string& product, OrderBookType type);
+
+    // Caller holds the lock: shared for find, exclusive for findOrBuild
+    Series* find(const std::string& key, const CandleInterval& interval);
+    Series& findOrBuild(const std::string& key, const std::string& product,
+        const CandleInterval& interval, OrderBookType type, const Loader& load);
+
+    static void update(Series& series, long long micros, double price, double amount);
+    static void resetIndicators(Series& series);
+    static IndicatorEngine withOpenCandle(const Series& series);
+
+    std::map<std::string, Entry> entries;   // Keyed by "product|side"
+    std::shared_mutex mutex;
+};
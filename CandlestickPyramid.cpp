@@ -0,0 +1,126 @@
+// ==================== CandlestickPyramid.cpp ====================
+/**
+ * CandlestickPyramid.cpp
+ * Implementation of multi-resolution candle rollups
+ */
+
+#include "CandlestickPyramid.h"
+#include "Timestamp.h"
+
+CandlestickPyramid::CandlestickPyramid(std::string _product, OrderBookType _type)
+    : product(_product),
+    type(_type)
+{
+    for (const CandleInterval& interval : CandleInterval::standardLevels())
+    {
+        levels.push_back(CandlestickAggregator(product, type, interval));
+    }
+}
+
+void CandlestickPyramid::addOrder(const OrderBookEntry& order)
+{
+    if (order.product != product || order.orderType != type) return;
+
+    long long micros = Timestamp::toMicros(order.timestamp);
+    if (micros >= 0)
+    {
+        addPrice(micros, order.price, order.amount);
+    }
+}
+
+void CandlestickPyramid::addPrice(long long micros, double price, double amount)
+{
+    typedef CandlestickAggregator::AddResult AddResult;
+
+    // 'carry' is what the level below could not absorb: a candle it just
+    // closed, or data that arrived after its bucket was rolled up
+    CandlestickAggregator::Bucket carry{ micros, price, price, price, price, amount, price * amount, 1 };
+    AddResult result = levels[0].addCandle(carry);
+
+    for (size_t level = 1; level < levels.size() && result != AddResult::merged; level++)
+    {
+        CandlestickAggregator& target = levels[level];
+        if (result == AddResult::closed)
+        {
+            carry = levels[level - 1].getClosed().back();
+            result = target.addCandle(carry);
+        }
+        else if (target.hasOpenCandle() &&
+            target.getInterval().bucketStart(carry.start) == target.getOpen().start)
+        {
+            // Late data for the open coarser candle: widen it, keep its close.
+            // Coarser levels will see it when that candle closes
+            target.addLate(carry);
+            result = AddResult::merged;
+        }
+        else
+        {
+            // Late data for a closed coarser candle, or one not started yet
+            result = target.addCandle(carry);
+        }
+    }
+}
+
+bool CandlestickPyramid::supports(const CandleInterval& interval)
+{
+    return CandleInterval::standardLevels().front().divides(interval);
+}
+
+std::vector<CandlestickAggregator::Bucket> CandlestickPyramid::getLevelBuckets(size_t index) const
+{
+    std::vector<CandlestickAggregator::Bucket> buckets = levels[index].getBuckets();
+    const CandleInterval& interval = levels[index].getInterval();
+
+    // Finer open candles are newer than anything rolled into this level
+    for (size_t i = index; i-- > 0;)
+    {
+        if (!levels[i].hasOpenCandle()) continue;
+
+        CandlestickAggregator::Bucket open = levels[i].getOpen();
+        open.start = interval.bucketStart(open.start);
+        if (!buckets.empty() && buckets.back().start == open.start)
+        {
+            CandlestickAggregator::merge(buckets.back(), open);
+        }
+        else
+        {
+            buckets.push_back(open);
+        }
+    }
+    return buckets;
+}
+
+std::vector<CandlestickAggregator::Bucket> CandlestickPyramid::getBuckets(const CandleInterval& interval) const
+{
+    // Exact level, else roll up the coarsest level that nests inside the interval
+    size_t source = levels.size();
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        if (levels[i].getInterval() == interval)
+        {
+            return getLevelBuckets(i);
+        }
+        if (levels[i].getInterval().divides(interval))
+        {
+            source = i;
+        }
+    }
+
+    if (source == levels.size())
+    {
+        return {};
+    }
+
+    CandlestickAggregator rollup(product, type, interval);
+    for (const CandlestickAggregator::Bucket& bucket : getLevelBuckets(source))
+    {
+        rollup.addCandle(bucket);
+    }
+    return rollup.getBuckets();
+}
+
+CandleSeries CandlestickPyramid::getSeries(const CandleInterval& interval) const
+{
+    CandlestickAggregator formatter(product, type, interval);
+    return formatter.toSeries(getBuckets(interval));
+}
@@ -0,0 +1,39 @@
+// ==================== CandlestickPyramid.h ====================
+/**
+ * CandlestickPyramid.h
+ * Multi-resolution candles for one product and order side
+ * TASK 1: Orders only update the finest level (1s). Each closed candle is
+ * rolled into the next coarser level (1m, 5m, 15m, 1h, 4h, 1d, 1M, 1y),
+ * so every standard resolution is ready without re-scanning orders and
+ * other intervals are rolled up from the nearest finer level
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "CandlestickAggregator.h"
+
+class CandlestickPyramid
+{
+public:
+    CandlestickPyramid(std::string _product, OrderBookType _type);
+
+    // Orders for other products or sides are ignored
+    void addOrder(const OrderBookEntry& order);
+    void addPrice(long long micros, double price, double amount);
+
+    // False for intervals the levels cannot build, i.e. finer than 1s
+    // or not a whole number of seconds
+    static bool supports(const CandleInterval& interval);
+
+    std::vector<CandlestickAggregator::Bucket> getBuckets(const CandleInterval& interval) const;
+    CandleSeries getSeries(const CandleInterval& interval) const;
+
+private:
+    // Level 'index' including the still-open candles of the finer levels
+    std::vector<CandlestickAggregator::Bucket> getLevelBuckets(size_t index) const;
+
+    std::string product;
+    OrderBookType type;
+    std::vector<CandlestickAggregator> levels;   // Finest first
+};
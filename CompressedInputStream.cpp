@@ -0,0 +1,119 @@
+// ==================== CompressedInputStream.cpp ====================
+/**
+ * CompressedInputStream.cpp
+ * Implementation of streaming decompression via a child process pipe
+ */
+
+#include "CompressedInputStream.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#else
+#include <sys/wait.h>
+#endif
+
+namespace
+{
+    bool endsWith(const std::string& s, const std::string& suffix)
+    {
+        return s.size() >= suffix.size() &&
+            s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Wrap a filename in quotes so spaces and shell characters are passed literally
+    std::string quoteForShell(const std::string& filename)
+    {
+#ifdef _WIN32
+        return "\"" + filename + "\"";
+#else
+        std::string quoted = "'";
+        for (char c : filename)
+        {
+            if (c == '\'') quoted += "'\\''";
+            else quoted += c;
+        }
+        return quoted + "'";
+#endif
+    }
+}
+
+CompressedInputStream::CompressedInputStream(std::string filename)
+    : std::istream(nullptr), pipe(nullptr)
+{
+    std::string command = decompressCommand(filename);
+    if (!command.empty())
+    {
+        pipe = popen(command.c_str(), "r");
+    }
+
+    if (pipe != nullptr)
+    {
+        pipeBuffer.attach(pipe);
+        rdbuf(&pipeBuffer);
+    }
+    else
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+CompressedInputStream::~CompressedInputStream()
+{
+    close();
+}
+
+bool CompressedInputStream::close()
+{
+    if (pipe == nullptr)
+    {
+        return false;
+    }
+
+    int status = pclose(pipe);
+    pipe = nullptr;
+    rdbuf(nullptr);
+    setstate(std::ios::failbit);
+
+#ifdef _WIN32
+    return status == 0;
+#else
+    // The shell exits with 127 when the tool is missing
+    return status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
+
+std::string CompressedInputStream::decompressCommand(std::string filename)
+{
+    if (endsWith(filename, ".gz"))
+    {
+        return "gzip -dc " + quoteForShell(filename);
+    }
+    if (endsWith(filename, ".zst"))
+    {
+        return "zstd -dcq " + quoteForShell(filename);
+    }
+    return "";
+}
+
+bool CompressedInputStream::isCompressed(std::string filename)
+{
+    return !decompressCommand(filename).empty();
+}
+
+CompressedInputStream::PipeBuffer::int_type CompressedInputStream::PipeBuffer::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    size_t bytesRead = std::fread(buffer, 1, sizeof(buffer), pipe);
+    if (bytesRead == 0)
+    {
+        return traits_type::eof();
+    }
+
+    setg(buffer, buffer, buffer + bytesRead);
+    return traits_type::to_int_type(*gptr());
+}
@@ -0,0 +1,49 @@
+// ==================== CompressedInputStream.h ====================
+/**
+ * CompressedInputStream.h
+ * std::istream that transparently decompresses .gz and .zst files
+ * Decompression is streamed through the system gzip/zstd tool, so nothing
+ * is written to disk and the parser sees plain CSV lines
+ */
+
+#pragma once
+#include <cstdio>
+#include <istream>
+#include <streambuf>
+#include <string>
+
+class CompressedInputStream : public std::istream
+{
+public:
+    CompressedInputStream(std::string filename);
+    ~CompressedInputStream();
+
+    bool is_open() const { return pipe != nullptr; }
+
+    // Waits for the decompressor to exit. False if it could not run or failed
+    // (tool not installed, corrupt or truncated archive), in which case what
+    // was read may be incomplete
+    bool close();
+
+    // Returns the decompress command for a filename, or "" for plain files
+    static std::string decompressCommand(std::string filename);
+    static bool isCompressed(std::string filename);
+
+private:
+    class PipeBuffer : public std::streambuf
+    {
+    public:
+        PipeBuffer() : pipe(nullptr) {}
+        void attach(FILE* _pipe) { pipe = _pipe; }
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        FILE* pipe;
+        char buffer[64 * 1024];
+    };
+
+    FILE* pipe;
+    PipeBuffer pipeBuffer;
+};
@@ -0,0 +1,96 @@
+// ==================== CurrencyRegistry.cpp ====================
+/**
+ * CurrencyRegistry.cpp
+ * Implementation of the currency ID registry
+ */
+
+#include "CurrencyRegistry.h"
+#include <mutex>
+
+CurrencyRegistry& CurrencyRegistry::instance()
+{
+    static CurrencyRegistry registry;
+    return registry;
+}
+
+int CurrencyRegistry::intern(const std::string& currency)
+{
+    // Caller holds the exclusive lock
+    auto it = ids.find(currency);
+    if (it != ids.end())
+    {
+        return it->second;
+    }
+    int id = (int)names.size();
+    names.push_back(currency);
+    ids.emplace(currency, id);
+    return id;
+}
+
+int CurrencyRegistry::getId(const std::string& currency)
+{
+    CurrencyRegistry& registry = instance();
+    {
+        std::shared_lock<std::shared_mutex> lock(registry.mutex);
+        auto it = registry.ids.find(currency);
+        if (it != registry.ids.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    return registry.intern(currency);
+}
+
+int CurrencyRegistry::findId(const std::string& currency)
+{
+    CurrencyRegistry& registry = instance();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    auto it = registry.ids.find(currency);
+    return it != registry.ids.end() ? it->second : NONE;
+}
+
+std::string CurrencyRegistry::getName(int id)
+{
+    CurrencyRegistry& registry = instance();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    if (id < 0 || (size_t)id >= registry.names.size())
+    {
+        return "";
+    }
+    return registry.names[id];
+}
+
+size_t CurrencyRegistry::size()
+{
+    CurrencyRegistry& registry = instance();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    return registry.names.size();
+}
+
+CurrencyRegistry::ProductIds CurrencyRegistry::resolveProduct(const std::string& product)
+{
+    CurrencyRegistry& registry = instance();
+    {
+        std::shared_lock<std::shared_mutex> lock(registry.mutex);
+        auto it = registry.products.find(product);
+        if (it != registry.products.end())
+        {
+            return it->second;
+        }
+    }
+
+    ProductIds pair{ NONE, NONE };
+    size_t slash = product.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 >= product.size())
+    {
+        return pair;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    pair.base = registry.intern(product.substr(0, slash));
+    pair.quote = registry.intern(product.substr(slash + 1));
+    registry.products.emplace(product, pair);
+    return pair;
+}
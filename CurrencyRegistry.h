@@ -0,0 +1,49 @@
+// ==================== CurrencyRegistry.h ====================
+/**
+ * CurrencyRegistry.h
+ * Process-wide mapping between currency codes and small integer IDs
+ * TASK 3: IDs are dense (0, 1, 2, ...) so wallets can index balances by
+ * array position; products are split into (base, quote) IDs once and the
+ * result is remembered
+ */
+
+#pragma once
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+class CurrencyRegistry
+{
+public:
+    static const int NONE = -1;
+
+    // "ETH/BTC" -> { ETH, BTC }
+    struct ProductIds
+    {
+        int base;
+        int quote;
+    };
+
+    // Assigns the next ID to a currency seen for the first time
+    static int getId(const std::string& currency);
+
+    // NONE if the currency has never been registered
+    static int findId(const std::string& currency);
+
+    static std::string getName(int id);
+    static size_t size();
+
+    // { NONE, NONE } if the product is not "BASE/QUOTE"
+    static ProductIds resolveProduct(const std::string& product);
+
+private:
+    static CurrencyRegistry& instance();
+
+    int intern(const std::string& currency);
+
+    std::shared_mutex mutex;
+    std::deque<std::string> names;    // Indexed by ID
+    std::unordered_map<std::string, int> ids;
+    std::unordered_map<std::string, ProductIds> products;
+};
@@ -1,340 +1,449 @@
-// ==================== DataManager.cpp ====================
-/**
- * DataManager.cpp
- * Implementation of data persistence and candlestick generation
- */
-
-#include "DataManager.h"
-#include "CSVReader.h"
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-#include <map>
-
-DataManager::DataManager()
-{
-    // Ensure CSV files exist
-    createFileIfNotExists(USERS_FILE);
-    createFileIfNotExists(TRANSACTIONS_FILE);
-    createFileIfNotExists(WALLET_FILE);
-}
-
-bool DataManager::fileExists(std::string filename)
-{
-    std::ifstream file(filename);
-    return file.good();
-}
-
-void DataManager::createFileIfNotExists(std::string filename)
-{
-    if (!fileExists(filename))
-    {
-        std::ofstream file(filename);
-        file.close();
-    }
-}
-
-// ==================== USER MANAGEMENT ====================
-
-bool DataManager::saveUser(const User& user)
-{
-    std::ofstream file(USERS_FILE, std::ios::app);
-    if (file.is_open())
-    {
-        file << user.toCSVString() << std::endl;
-        file.close();
-        return true;
-    }
-    return false;
-}
-
-User DataManager::loadUser(std::string username)
-{
-    std::ifstream file(USERS_FILE);
-    std::string line;
-    if (file.is_open())
-    {
-        while (std::getline(file, line))
-        {
-            User user = User::fromCSVString(line);
-            if (user.getUsername() == username)
-            {
-                file.close();
-                return user;
-            }
-        }
-        file.close();
-    }
-    return User();
-}
-
-std::vector<User> DataManager::loadAllUsers()
-{
-    std::vector<User> users;
-    std::ifstream file(USERS_FILE);
-    std::string line;
-    if (file.is_open())
-    {
-        while (std::getline(file, line))
-        {
-            if (!line.empty())
-            {
-                users.push_back(User::fromCSVString(line));
-            }
-        }
-        file.close();
-    }
-    return users;
-}
-
-bool DataManager::userExists(std::string email, std::string fullName)
-{
-    std::vector<User> users = loadAllUsers();
-    for (const User& user : users)
-    {
-        if (user.getEmail() == email && user.getFullName() == fullName)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-User DataManager::getUserByEmail(std::string email)
-{
-    std::vector<User> users = loadAllUsers();
-    for (const User& user : users)
-    {
-        if (user.getEmail() == email)
-        {
-            return user;
-        }
-    }
-    return User();
-}
-
-// ==================== TRANSACTION MANAGEMENT ====================
-
-bool DataManager::saveTransaction(const Transaction& transaction)
-{
-    std::ofstream file(TRANSACTIONS_FILE, std::ios::app);
-    if (file.is_open())
-    {
-        file << transaction.toCSVString() << std::endl;
-        file.close();
-        return true;
-    }
-    return false;
-}
-
-std::vector<Transaction> DataManager::loadUserTransactions(std::string username)
-{
-    std::vector<Transaction> transactions;
-    std::ifstream file(TRANSACTIONS_FILE);
-    std::string line;
-    if (file.is_open())
-    {
-        while (std::getline(file, line))
-        {
-            if (!line.empty())
-            {
-                Transaction trans = Transaction::fromCSVString(line);
-                if (trans.getUsername() == username)
-                {
-                    transactions.push_back(trans);
-                }
-            }
-        }
-        file.close();
-    }
-    return transactions;
-}
-
-std::vector<Transaction> DataManager::loadUserTransactions(std::string username, int limit)
-{
-    std::vector<Transaction> allTransactions = loadUserTransactions(username);
-    std::vector<Transaction> recentTransactions;
-
-    // Get last 'limit' transactions
-    int start = std::max(0, (int)allTransactions.size() - limit);
-    for (size_t i = start; i < allTransactions.size(); i++)
-    {
-        recentTransactions.push_back(allTransactions[i]);
-    }
-
-    return recentTransactions;
-}
-
-std::vector<Transaction> DataManager::loadUserTransactionsByProduct(std::string username, std::string product)
-{
-    std::vector<Transaction> transactions;
-    std::ifstream file(TRANSACTIONS_FILE);
-    std::string line;
-    if (file.is_open())
-    {
-        while (std::getline(file, line))
-        {
-            if (!line.empty())
-            {
-                Transaction trans = Transaction::fromCSVString(line);
-                if (trans.getUsername() == username && trans.getProduct() == product)
-                {
-                    transactions.push_back(trans);
-                }
-            }
-        }
-        file.close();
-    }
-    return transactions;
-}
-
-// ==================== WALLET MANAGEMENT ====================
-
-bool DataManager::saveWalletBalance(std::string username, std::string currency, double amount)
-{
-    std::vector<std::string> lines;
-    std::ifstream inFile(WALLET_FILE);
-    std::string line;
-    bool found = false;
-
-    if (inFile.is_open())
-    {
-        while (std::getline(inFile, line))
-        {
-            std::vector<std::string> tokens = CSVReader::tokenise(line, ',');
-            if (tokens.size() == 3 && tokens[0] == username && tokens[1] == currency)
-            {
-                // Update existing entry
-                lines.push_back(username + "," + currency + "," + std::to_string(amount));
-                found = true;
-            }
-            else if (!line.empty())
-            {
-                lines.push_back(line);
-            }
-        }
-        inFile.close();
-    }
-
-    // Add new entry if not found
-    if (!found)
-    {
-        lines.push_back(username + "," + currency + "," + std::to_string(amount));
-    }
-
-    // Write back to file
-    std::ofstream outFile(WALLET_FILE);
-    if (outFile.is_open())
-    {
-        for (const std::string& l : lines)
-        {
-            outFile << l << std::endl;
-        }
-        outFile.close();
-        return true;
-    }
-
-    return false;
-}
-
-std::map<std::string, double> DataManager::loadWalletBalance(std::string username)
-{
-    std::map<std::string, double> wallet;
-    std::ifstream file(WALLET_FILE);
-    std::string line;
-
-    if (file.is_open())
-    {
-        while (std::getline(file, line))
-        {
-            if (!line.empty())
-            {
-                std::vector<std::string> tokens = CSVReader::tokenise(line, ',');
-                if (tokens.size() == 3 && tokens[0] == username)
-                {
-                    wallet[tokens[1]] = std::stod(tokens[2]);
-                }
-            }
-        }
-        file.close();
-    }
-
-    return wallet;
-}
-
-// ==================== TASK 1: CANDLESTICK GENERATION ====================
-
-std::vector<Candlestick> DataManager::generateCandlesticks(
-    const std::vector<OrderBookEntry>& orders,
-    std::string product,
-    std::string period,
-    OrderBookType type)
-{
-    std::vector<Candlestick> candlesticks;
-
-    // Group orders by date period
-    std::map<std::string, std::vector<OrderBookEntry>> groupedOrders;
-
-    for (const OrderBookEntry& order : orders)
-    {
-        if (order.product == product && order.orderType == type)
-        {
-            std::string dateKey = extractDate(order.timestamp, period);
-            groupedOrders[dateKey].push_back(order);
-        }
-    }
-
-    // Generate candlestick for each period
-    for (auto& pair : groupedOrders)
-    {
-        std::string date = pair.first;
-        std::vector<OrderBookEntry>& periodOrders = pair.second;
-
-        if (periodOrders.empty()) continue;
-
-        // Calculate OHLC values
-        double open = periodOrders[0].price;
-        double close = periodOrders[periodOrders.size() - 1].price;
-        double high = periodOrders[0].price;
-        double low = periodOrders[0].price;
-
-        for (const OrderBookEntry& order : periodOrders)
-        {
-            if (order.price > high) high = order.price;
-            if (order.price < low) low = order.price;
-        }
-
-        std::string typeStr = (type == OrderBookType::ask) ? "ask" : "bid";
-        candlesticks.push_back(Candlestick(date, open, high, low, close, product, typeStr));
-    }
-
-    // Sort chronologically
-    std::sort(candlesticks.begin(), candlesticks.end(), Candlestick::compareByDate);
-
-    return candlesticks;
-}
-
-std::string DataManager::extractDate(std::string timestamp, std::string period)
-{
-    // Timestamp format: 2020/03/17 17:01:24.884492
-    if (timestamp.length() < 10) return timestamp;
-
-    std::string year = timestamp.substr(0, 4);
-    std::string month = timestamp.substr(5, 2);
-    std::string day = timestamp.substr(8, 2);
-
-    if (period == "daily")
-    {
-        return year + "-" + month + "-" + day;
-    }
-    else if (period == "monthly")
-    {
-        return year + "-" + month;
-    }
-    else if (period == "yearly")
-    {
-        return year;
-    }
-
-    return year + "-" + month + "-" + day;
+// ==================== DataManager.cpp ====================
+/**
+ * DataManager.cpp
+ * Implementation of data persistence and candlestick generation
+ */
+
+#include "DataManager.h"
+#include "CSVReader.h"
+#include "Timestamp.h"
+#include "CandlestickAggregator.h"
+#include "CandlestickBatch.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <limits>
+
+DataManager::DataManager()
+    : walletLedger(WALLET_FILE, asyncIO),
+    usersLock(USERS_FILE + ".lock"),
+    transactionsLock(TRANSACTIONS_FILE + ".lock"),
+    transactionIndex(TRANSACTIONS_FILE, TRANSACTIONS_INDEX_FILE, transactionsLock),
+    transactionStore(TRANSACTIONS_STORE_DIR, transactionsLock),
+    transactionWriter(TRANSACTIONS_FILE, transactionIndex, &transactionStore),
+    usersReadOffset(0)
+{
+    // Ensure CSV files exist
+    createFileIfNotExists(USERS_FILE);
+    createFileIfNotExists(TRANSACTIONS_FILE);
+    createFileIfNotExists(WALLET_FILE);
+
+    // First run with the binary store: seed it from the existing CSV log
+    FileLock::Guard guard(transactionsLock, true);
+    if (transactionStore.isEmpty())
+    {
+        importTransactionsIntoStore();
+    }
+}
+
+bool DataManager::fileExists(std::string filename)
+{
+    std::ifstream file(filename);
+    return file.good();
+}
+
+void DataManager::createFileIfNotExists(std::string filename)
+{
+    if (!fileExists(filename))
+    {
+        std::ofstream file(filename);
+        file.close();
+    }
+}
+
+// ==================== USER MANAGEMENT ====================
+
+bool DataManager::saveUser(const User& user)
+{
+    FileLock::Guard guard(usersLock, true);
+    refreshUsers();
+
+    std::ofstream file(USERS_FILE, std::ios::app | std::ios::binary);
+    if (file.is_open())
+    {
+        file << user.toCSVString() << '\n';
+        file.close();
+
+        // Index our record (and anything appended just before it) from the file
+        refreshUsers();
+        return true;
+    }
+    return false;
+}
+
+User DataManager::loadUser(std::string username)
+{
+    refreshUsers();
+
+    auto it = usersByUsername.find(username);
+    if (it != usersByUsername.end())
+    {
+        return it->second;
+    }
+    return User();
+}
+
+std::vector<User> DataManager::loadAllUsers()
+{
+    std::vector<User> users;
+    std::ifstream file(USERS_FILE);
+    std::string line;
+    if (file.is_open())
+    {
+        while (std::getline(file, line))
+        {
+            if (!line.empty())
+            {
+                users.push_back(User::fromCSVString(line));
+            }
+        }
+        file.close();
+    }
+    return users;
+}
+
+bool DataManager::userExists(std::string email, std::string fullName)
+{
+    refreshUsers();
+    return emailAndNameKeys.count(emailAndNameKey(email, fullName)) > 0;
+}
+
+User DataManager::getUserByEmail(std::string email)
+{
+    refreshUsers();
+
+    auto it = usernameByEmail.find(email);
+    if (it != usernameByEmail.end())
+    {
+        return usersByUsername[it->second];
+    }
+    return User();
+}
+
+void DataManager::refreshUsers()
+{
+    FileLock::Guard guard(usersLock, false);
+
+    std::ifstream file(USERS_FILE, std::ios::binary);
+    if (!file.is_open()) return;
+
+    // Index only the complete lines appended since the last refresh
+    file.seekg(usersReadOffset);
+    std::string line;
+    while (std::getline(file, line) && !file.eof())
+    {
+        usersReadOffset = file.tellg();
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty())
+        {
+            indexUser(User::fromCSVString(line));
+        }
+    }
+}
+
+void DataManager::indexUser(const User& user)
+{
+    if (user.getUsername().empty()) return;
+
+    // emplace keeps the first record, matching the old first-match-in-file lookups
+    usersByUsername.emplace(user.getUsername(), user);
+    usernameByEmail.emplace(user.getEmail(), user.getUsername());
+    emailAndNameKeys.insert(emailAndNameKey(user.getEmail(), user.getFullName()));
+}
+
+std::string DataManager::emailAndNameKey(const std::string& email, const std::string& fullName)
+{
+    // Newline cannot appear inside a CSV field, so it is a safe separator
+    return email + "\n" + fullName;
+}
+
+// ==================== TRANSACTION MANAGEMENT ====================
+
+bool DataManager::saveTransaction(const Transaction& transaction)
+{
+    return transactionWriter.submit(transaction);
+}
+
+std::vector<Transaction> DataManager::queryTransactions(std::string fromTimestamp,
+    std::string toTimestamp,
+    std::string username,
+    std::string product)
+{
+    long long fromMicros = fromTimestamp.empty() ? 0 : Timestamp::toMicros(fromTimestamp);
+    long long toMicros = toTimestamp.empty() ? std::numeric_limits<long long>::max()
+        : Timestamp::toMicros(toTimestamp);
+    if (fromMicros < 0 || toMicros < 0)
+    {
+        return std::vector<Transaction>();
+    }
+
+    // A date-only upper bound includes the whole of that day
+    if (!toTimestamp.empty() && toTimestamp.length() <= 10)
+    {
+        toMicros += 86400 * Timestamp::MICROS_PER_SECOND - 1;
+    }
+
+    flushTransactions();
+    return transactionStore.query(fromMicros, toMicros, username, product);
+}
+
+void DataManager::importTransactionsIntoStore()
+{
+    std::ifstream file(TRANSACTIONS_FILE);
+    std::string line;
+    std::vector<Transaction> batch;
+    Transaction transaction;
+    size_t skipped = 0;
+
+    while (std::getline(file, line))
+    {
+        if (line.empty()) continue;
+
+        // A damaged line must not stop startup or become an empty record
+        if (!Transaction::parseCSVString(line, transaction))
+        {
+            skipped++;
+            continue;
+        }
+        batch.push_back(transaction);
+        if (batch.size() == TransactionStore::RECORDS_PER_SEGMENT)
+        {
+            transactionStore.append(batch);
+            batch.clear();
+        }
+    }
+    if (!batch.empty())
+    {
+        transactionStore.append(batch);
+    }
+    if (skipped > 0)
+    {
+        std::cout << "DataManager::importTransactionsIntoStore: skipped " << skipped
+            << " malformed lines in " << TRANSACTIONS_FILE << std::endl;
+    }
+}
+
+void DataManager::flushTransactions()
+{
+    transactionWriter.flush();
+}
+
+void DataManager::setDurabilityPolicy(DurabilityPolicy policy)
+{
+    transactionWriter.setPolicy(policy);
+}
+
+std::vector<Transaction> DataManager::loadUserTransactions(std::string username)
+{
+    flushTransactions();
+    transactionIndex.refresh();
+    return readTransactionsAt(transactionIndex.getOffsets(username));
+}
+
+std::vector<Transaction> DataManager::loadUserTransactions(std::string username, int limit)
+{
+    std::vector<Transaction> recentTransactions;
+    if (limit <= 0) return recentTransactions;
+
+    flushTransactions();
+
+    std::ifstream file(TRANSACTIONS_FILE, std::ios::binary);
+    if (!file.is_open()) return recentTransactions;
+
+    // Read the log backwards in blocks, stopping once 'limit' records are found
+    const long long BLOCK_SIZE = 64 * 1024;
+    const std::string prefix = username + ",";
+    std::vector<char> block(BLOCK_SIZE);
+    std::string partial;   // Start of a line whose beginning is in an earlier block
+
+    file.seekg(0, std::ios::end);
+    long long position = file.tellg();
+
+    while (position > 0 && (int)recentTransactions.size() < limit)
+    {
+        long long readSize = std::min(BLOCK_SIZE, position);
+        position -= readSize;
+        file.seekg(position);
+        file.read(block.data(), readSize);
+
+        std::string chunk(block.data(), (size_t)readSize);
+        chunk += partial;
+
+        // Every line after the first newline is complete; walk them newest first
+        size_t lineEnd = chunk.size();
+        size_t newline = chunk.rfind('\n', lineEnd == 0 ? 0 : lineEnd - 1);
+        while (newline != std::string::npos && (int)recentTransactions.size() < limit)
+        {
+            std::string line = chunk.substr(newline + 1, lineEnd - newline - 1);
+            Transaction transaction;
+            if (line.compare(0, prefix.size(), prefix) == 0 &&
+                Transaction::parseCSVString(line, transaction))
+            {
+                recentTransactions.push_back(transaction);
+            }
+            lineEnd = newline;
+            newline = newline == 0 ? std::string::npos : chunk.rfind('\n', newline - 1);
+        }
+        partial = chunk.substr(0, lineEnd);
+    }
+
+    // The first line of the file has no newline before it
+    Transaction first;
+    if (position == 0 && (int)recentTransactions.size() < limit &&
+        partial.compare(0, prefix.size(), prefix) == 0 &&
+        Transaction::parseCSVString(partial, first))
+    {
+        recentTransactions.push_back(first);
+    }
+
+    // Collected newest first; return in chronological order like the full history
+    std::reverse(recentTransactions.begin(), recentTransactions.end());
+    return recentTransactions;
+}
+
+std::vector<Transaction> DataManager::loadUserTransactionsByProduct(std::string username, std::string product)
+{
+    flushTransactions();
+    transactionIndex.refresh();
+    return readTransactionsAt(transactionIndex.getOffsets(username, product));
+}
+
+std::vector<Transaction> DataManager::readTransactionsAt(const std::vector<long long>& offsets)
+{
+    std::vector<Transaction> transactions;
+    std::ifstream file(TRANSACTIONS_FILE, std::ios::binary);
+    std::string line;
+    if (file.is_open())
+    {
+        for (long long offset : offsets)
+        {
+            file.seekg(offset);
+            Transaction transaction;
+            if (std::getline(file, line) && Transaction::parseCSVString(line, transaction))
+            {
+                transactions.push_back(transaction);
+            }
+            file.clear();
+        }
+        file.close();
+    }
+    return transactions;
+}
+
+// ==================== WALLET MANAGEMENT ====================
+
+bool DataManager::claimUser(const std::string& username)
+{
+    if (userClaims.count(username))
+    {
+        return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(SESSIONS_DIR, error);
+    std::unique_ptr<FileLock> claim(new FileLock(
+        (std::filesystem::path(SESSIONS_DIR) / (username + ".lock")).string()));
+    if (!claim->tryLockExclusiveDetached())
+    {
+        return false;
+    }
+
+    // Held until the process exits; closing the lock file releases it
+    userClaims[username] = std::move(claim);
+    return true;
+}
+
+bool DataManager::saveWalletBalance(std::string username, std::string currency, double amount)
+{
+    // O(1) append; the ledger compacts the file once stale records pile up
+    return walletLedger.append(username, currency, amount);
+}
+
+bool DataManager::saveWallet(std::string username, const std::map<std::string, double>& balances)
+{
+    // Persists every currency of the wallet in one write
+    return walletLedger.appendAll(username, balances);
+}
+
+bool DataManager::flush()
+{
+    flushTransactions();
+    return walletLedger.flush();
+}
+
+std::map<std::string, double> DataManager::loadWalletBalance(std::string username)
+{
+    return walletLedger.getBalances(username);
+}
+
+// ==================== TASK 1: CANDLESTICK GENERATION ====================
+
+CandleSeries DataManager::generateCandlesticks(
+    const std::vector<OrderBookEntry>& orders,
+    std::string product,
+    std::string period,
+    OrderBookType type)
+{
+    CandleInterval interval;
+    if (!CandleInterval::parse(period, interval))
+    {
+        std::cout << "DataManager::generateCandlesticks: unknown interval " << period << std::endl;
+        return CandleSeries(product, type, interval);
+    }
+
+    // Gather the product's ticks into columns, then reduce each bucket
+    // in one fused pass (OHLC, volume and VWAP together)
+    std::vector<long long> times;
+    std::vector<double> prices;
+    std::vector<double> amounts;
+    for (const OrderBookEntry& order : orders)
+    {
+        if (order.product != product || order.orderType != type) continue;
+
+        long long micros = Timestamp::toMicros(order.timestamp);
+        if (micros < 0) continue;
+
+        times.push_back(micros);
+        prices.push_back(order.price);
+        amounts.push_back(order.amount);
+    }
+
+    CandlestickAggregator aggregator(product, type, interval);
+    aggregator.addColumns(times.data(), prices.data(), amounts.data(), times.size());
+    return aggregator.getSeries();
+}
+
+std::vector<CandleSeries> DataManager::generateAllCandlesticks(
+    const std::vector<OrderBookEntry>& orders,
+    const std::vector<std::string>& periods,
+    unsigned threads)
+{
+    return CandlestickBatch::generateAll(orders, periods, threads);
+}
+
+std::string DataManager::extractDate(std::string timestamp, std::string period)
+{
+    // Timestamp format: 2020/03/17 17:01:24.884492
+    if (timestamp.length() < 10) return timestamp;
+
+    std::string year = timestamp.substr(0, 4);
+    std::string month = timestamp.substr(5, 2);
+    std::string day = timestamp.substr(8, 2);
+
+    if (period == "daily")
+    {
+        return year + "-" + month + "-" + day;
+    }
+    else if (period == "monthly")
+    {
+        return year + "-" + month;
+    }
+    else if (period == "yearly")
+    {
+        return year;
+    }
+
+    return year + "-" + month + "-" + day;
 }
\ No newline at end of file
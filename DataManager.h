@@ -1,55 +1,124 @@
-// ==================== DataManager.h ====================
-/**
- * DataManager.h
- * Handles all file I/O operations for persistent data storage
- * TASKS 1, 2, 3: Manages users, transactions, wallet, and candlestick generation
- */
-
-#pragma once
-#include <string>
-#include <vector>
-#include <map>
-#include "User.h"
-#include "Transaction.h"
-#include "Candlestick.h"
-#include "OrderBookEntry.h"
-
-class DataManager
-{
-public:
-    DataManager();
-
-    // TASK 2: User management
-    bool saveUser(const User& user);
-    User loadUser(std::string username);
-    std::vector<User> loadAllUsers();
-    bool userExists(std::string email, std::string fullName);
-    User getUserByEmail(std::string email);
-
-    // TASK 3: Transaction management
-    bool saveTransaction(const Transaction& transaction);
-    std::vector<Transaction> loadUserTransactions(std::string username);
-    std::vector<Transaction> loadUserTransactions(std::string username, int limit);
-    std::vector<Transaction> loadUserTransactionsByProduct(std::string username, std::string product);
-
-    // TASK 3: Wallet balance management
-    bool saveWalletBalance(std::string username, std::string currency, double amount);
-    std::map<std::string, double> loadWalletBalance(std::string username);
-
-    // TASK 1: Candlestick data generation
-    std::vector<Candlestick> generateCandlesticks(
-        const std::vector<OrderBookEntry>& orders,
-        std::string product,
-        std::string period,  // "daily", "monthly", "yearly"
-        OrderBookType type); // ask or bid
-
-    static std::string extractDate(std::string timestamp, std::string period);
-
-private:
-    const std::string USERS_FILE = "users.csv";
-    const std::string TRANSACTIONS_FILE = "transactions.csv";
-    const std::string WALLET_FILE = "wallet.csv";
-
-    bool fileExists(std::string filename);
-    void createFileIfNotExists(std::string filename);
+// ==================== DataManager.h ====================
+/**
+ * DataManager.h
+ * Handles all file I/O operations for persistent data storage
+ * TASKS 1, 2, 3: Manages users, transactions, wallet, and candlestick generation
+ *
+ * Several simulator processes can share one data directory: every file is
+ * guarded by an advisory "<file>.lock" and in-memory views catch up on
+ * records other processes appended before they are used
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "User.h"
+#include "Transaction.h"
+#include "CandleSeries.h"
+#include "OrderBookEntry.h"
+#include "WalletLedger.h"
+#include "TransactionIndex.h"
+#include "TransactionWriter.h"
+#include "TransactionStore.h"
+#include "FileLock.h"
+#include "AsyncIO.h"
+
+class DataManager
+{
+public:
+    DataManager();
+
+    // TASK 2: User management
+    bool saveUser(const User& user);
+    User loadUser(std::string username);
+    std::vector<User> loadAllUsers();
+    bool userExists(std::string email, std::string fullName);
+    User getUserByEmail(std::string email);
+
+    // TASK 3: Transaction management
+    bool saveTransaction(const Transaction& transaction);
+    std::vector<Transaction> loadUserTransactions(std::string username);
+    std::vector<Transaction> loadUserTransactions(std::string username, int limit);
+    std::vector<Transaction> loadUserTransactionsByProduct(std::string username, std::string product);
+
+    // Range query over the binary store; empty arguments are unbounded / match all
+    std::vector<Transaction> queryTransactions(std::string fromTimestamp,
+        std::string toTimestamp,
+        std::string username = "",
+        std::string product = "");
+
+    // saveTransaction is asynchronous: records are group-committed by a background writer
+    void flushTransactions();
+    void setDurabilityPolicy(DurabilityPolicy policy);
+
+    // TASK 3: Wallet balance management
+    // Wallets are saved as absolute balances, so two processes trading for
+    // one user would overwrite each other's changes. A process claims each
+    // user it logs in until it exits; false if another process holds them
+    bool claimUser(const std::string& username);
+    bool saveWalletBalance(std::string username, std::string currency, double amount);
+    bool saveWallet(std::string username, const std::map<std::string, double>& balances);
+    std::map<std::string, double> loadWalletBalance(std::string username);
+
+    // Waits until every queued transaction and wallet write is on disk
+    bool flush();
+
+    // TASK 1: Candlestick data generation
+    CandleSeries generateCandlesticks(
+        const std::vector<OrderBookEntry>& orders,
+        std::string product,
+        std::string period,  // "1s", "5m", "1h", "daily", "monthly", "yearly", ...
+        OrderBookType type); // ask or bid
+
+    // Every product x side x interval in one pass, split across threads
+    std::vector<CandleSeries> generateAllCandlesticks(
+        const std::vector<OrderBookEntry>& orders,
+        const std::vector<std::string>& periods,
+        unsigned threads = 0);  // 0 = every core
+
+    static std::string extractDate(std::string timestamp, std::string period);
+
+private:
+    const std::string USERS_FILE = "users.csv";
+    const std::string TRANSACTIONS_FILE = "transactions.csv";
+    const std::string WALLET_FILE = "wallet.csv";
+    const std::string TRANSACTIONS_INDEX_FILE = "transactions.idx";
+    const std::string TRANSACTIONS_STORE_DIR = "transactions.db";
+    const std::string SESSIONS_DIR = "sessions";    // One "<username>.lock" per claimed user
+
+    // Non-blocking writes (io_uring on Linux); must outlive everything that submits to it
+    AsyncIO asyncIO;
+
+    // Append-only wallet log; must be declared after WALLET_FILE
+    WalletLedger walletLedger;
+
+    // Inter-process locks; must be declared after the file names
+    FileLock usersLock;
+    FileLock transactionsLock;
+
+    // Per-user offsets into TRANSACTIONS_FILE
+    TransactionIndex transactionIndex;
+    TransactionStore transactionStore;
+    TransactionWriter transactionWriter;
+    void importTransactionsIntoStore();
+    std::vector<Transaction> readTransactionsAt(const std::vector<long long>& offsets);
+
+    // In-memory user directory over USERS_FILE, caught up incrementally
+    long long usersReadOffset;   // Bytes of USERS_FILE already indexed
+    std::unordered_map<std::string, User> usersByUsername;
+    std::unordered_map<std::string, std::string> usernameByEmail;
+    std::unordered_set<std::string> emailAndNameKeys;
+
+    std::map<std::string, std::unique_ptr<FileLock>> userClaims;
+
+    void refreshUsers();
+    void indexUser(const User& user);
+    static std::string emailAndNameKey(const std::string& email, const std::string& fullName);
+
+    bool fileExists(std::string filename);
+    void createFileIfNotExists(std::string filename);
 };
\ No newline at end of file
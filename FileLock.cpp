@@ -0,0 +1,255 @@
+// ==================== FileLock.cpp ====================
+/**
+ * FileLock.cpp
+ * Implementation of advisory file locking (flock on POSIX, LockFileEx on Windows)
+ */
+
+#include "FileLock.h"
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <cerrno>
+#endif
+
+FileLock::FileLock(std::string _lockFilename)
+    : lockFilename(_lockFilename),
+    readers(0),
+    writersWaiting(0),
+    writer(false),
+    sharedOsHolds(0),
+#ifdef _WIN32
+    handle(INVALID_HANDLE_VALUE)
+#else
+    fd(-1)
+#endif
+{
+}
+
+FileLock::~FileLock()
+{
+#ifdef _WIN32
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)handle);
+#else
+    if (fd >= 0) close(fd);    // Closing also drops any lock still held
+#endif
+}
+
+bool FileLock::openLockFile()
+{
+#ifdef _WIN32
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        handle = CreateFileA(lockFilename.c_str(), GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    return handle != INVALID_HANDLE_VALUE;
+#else
+    if (fd < 0)
+    {
+        fd = open(lockFilename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    }
+    return fd >= 0;
+#endif
+}
+
+bool FileLock::acquire(bool exclusive, bool wait)
+{
+    if (!openLockFile()) return false;
+
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    DWORD flags = exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+    if (!wait) flags |= LOCKFILE_FAIL_IMMEDIATELY;
+    return LockFileEx((HANDLE)handle, flags, 0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+#else
+    // Only ever called with no lock held: flock() may drop a held lock
+    // before converting it
+    int operation = (exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB);
+    int result;
+    do
+    {
+        result = flock(fd, operation);
+    } while (result != 0 && errno == EINTR);
+    return result == 0;
+#endif
+}
+
+void FileLock::release()
+{
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    UnlockFileEx((HANDLE)handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+    flock(fd, LOCK_UN);
+#endif
+}
+
+namespace
+{
+    // This thread's nested holds of each lock
+    struct Hold
+    {
+        int depth = 0;
+        bool exclusive = false;
+    };
+    thread_local std::unordered_map<const FileLock*, Hold> threadHolds;
+}
+
+void FileLock::enterShared()
+{
+    {
+        std::unique_lock<std::mutex> gate(gateMutex);
+        gateChanged.wait(gate, [this] { return !writer && writersWaiting == 0; });
+        readers++;
+    }
+
+    // The first reader takes the OS lock; later ones wait here until it has
+    std::lock_guard<std::mutex> os(osMutex);
+    if (sharedOsHolds++ == 0)
+    {
+        acquire(false);
+    }
+}
+
+void FileLock::leaveShared()
+{
+    {
+        std::lock_guard<std::mutex> os(osMutex);
+        if (--sharedOsHolds == 0)
+        {
+            release();
+        }
+    }
+
+    std::lock_guard<std::mutex> gate(gateMutex);
+    readers--;
+    if (readers == 0) gateChanged.notify_all();
+}
+
+void FileLock::enterExclusive()
+{
+    {
+        std::unique_lock<std::mutex> gate(gateMutex);
+        writersWaiting++;
+        gateChanged.wait(gate, [this] { return !writer && readers == 0; });
+        writersWaiting--;
+        writer = true;
+    }
+
+    // No reader or writer in this process holds the OS lock now
+    std::lock_guard<std::mutex> os(osMutex);
+    acquire(true);
+}
+
+void FileLock::leaveExclusive()
+{
+    {
+        std::lock_guard<std::mutex> os(osMutex);
+        release();
+    }
+
+    std::lock_guard<std::mutex> gate(gateMutex);
+    writer = false;
+    gateChanged.notify_all();
+}
+
+void FileLock::lockShared()
+{
+    Hold& hold = threadHolds[this];
+    if (hold.depth == 0)
+    {
+        enterShared();
+        hold.exclusive = false;
+    }
+    hold.depth++;
+}
+
+void FileLock::lockExclusive()
+{
+    Hold& hold = threadHolds[this];
+    if (hold.depth > 0 && !hold.exclusive)
+    {
+        throw std::logic_error("FileLock::lockExclusive: " + lockFilename +
+            " is already held shared by this thread");
+    }
+    if (hold.depth == 0)
+    {
+        enterExclusive();
+        hold.exclusive = true;
+    }
+    hold.depth++;
+}
+
+void FileLock::unlock()
+{
+    auto it = threadHolds.find(this);
+    if (it == threadHolds.end() || it->second.depth == 0) return;
+
+    Hold& hold = it->second;
+    hold.depth--;
+    if (hold.depth == 0)
+    {
+        if (hold.exclusive) leaveExclusive();
+        else leaveShared();
+        threadHolds.erase(it);
+    }
+}
+
+void FileLock::lockSharedDetached()
+{
+    enterShared();
+}
+
+void FileLock::unlockDetached()
+{
+    leaveShared();
+}
+
+bool FileLock::tryLockExclusiveDetached()
+{
+    {
+        std::lock_guard<std::mutex> gate(gateMutex);
+        if (writer || readers > 0 || writersWaiting > 0)
+        {
+            return false;
+        }
+        writer = true;
+    }
+
+    bool acquired;
+    {
+        std::lock_guard<std::mutex> os(osMutex);
+        acquired = acquire(true, false);
+    }
+    if (!acquired)
+    {
+        std::lock_guard<std::mutex> gate(gateMutex);
+        writer = false;
+        gateChanged.notify_all();
+    }
+    return acquired;
+}
+
+void FileLock::unlockExclusiveDetached()
+{
+    leaveExclusive();
+}
+
+FileLock::Guard::Guard(FileLock& _lock, bool exclusive)
+    : lock(_lock)
+{
+    if (exclusive) lock.lockExclusive();
+    else lock.lockShared();
+}
+
+FileLock::Guard::~Guard()
+{
+    lock.unlock();
+}
@@ -0,0 +1,83 @@
+// ==================== FileLock.h ====================
+/**
+ * FileLock.h
+ * Advisory inter-process lock on a "<file>.lock" companion file
+ * Lets several simulator processes share one data directory: readers take
+ * the lock shared, anything that appends or rewrites a data file takes it
+ * exclusive. Threads of one process are ordered by a reader/writer gate in
+ * front of the OS lock, so an exclusive holder excludes other threads too.
+ * Nested acquisitions by one thread are counted; a thread holding the lock
+ * shared may not ask for it exclusive, since converting in place would let
+ * another process in between
+ */
+
+#pragma once
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+class FileLock
+{
+public:
+    FileLock(std::string _lockFilename);
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // Re-entrant per thread; lockExclusive throws std::logic_error if the
+    // calling thread already holds the lock shared
+    void lockShared();
+    void lockExclusive();
+    void unlock();
+
+    // A shared hold that belongs to no thread, for work that completes on
+    // another thread (e.g. WalletLedger's in-flight appends); any thread may
+    // release it
+    void lockSharedDetached();
+    void unlockDetached();
+
+    // Exclusive hold that belongs to no thread and never waits: false at
+    // once if any thread or process holds the lock. For claims that last as
+    // long as a login (DataManager::claimUser)
+    bool tryLockExclusiveDetached();
+    void unlockExclusiveDetached();
+
+    // RAII helper: holds the lock for the lifetime of the guard
+    class Guard
+    {
+    public:
+        Guard(FileLock& _lock, bool exclusive);
+        ~Guard();
+
+    private:
+        FileLock& lock;
+    };
+
+private:
+    bool openLockFile();
+    bool acquire(bool exclusive, bool wait = true);
+    void release();
+
+    // Thread gate, then the OS lock; each is taken from unlocked, never converted
+    void enterShared();
+    void leaveShared();
+    void enterExclusive();
+    void leaveExclusive();
+
+    std::string lockFilename;
+
+    std::mutex gateMutex;
+    std::condition_variable gateChanged;
+    int readers;            // Shared holds in this process (threads and detached)
+    int writersWaiting;     // Waiting writers hold off new readers
+    bool writer;
+
+    std::mutex osMutex;     // Serialises the OS lock calls
+    int sharedOsHolds;      // Shared holds that went through the OS lock
+#ifdef _WIN32
+    void* handle;
+#else
+    int fd;
+#endif
+};
@@ -0,0 +1,341 @@
+// ==================== IndicatorEngine.cpp ====================
+/**
+ * IndicatorEngine.cpp
+ * Implementation of incremental and batch indicator evaluation
+ */
+
+#include "IndicatorEngine.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    const double NOT_READY = std::numeric_limits<double>::quiet_NaN();
+
+    // The kernels below keep loop-carried work (prefix sums, smoothing) in
+    // short scans and do the rest in branch-free element-wise loops that
+    // the compiler vectorises
+
+    // out[i] = mean of in[i-period+1 .. i]; 'first' is the first valid input
+    std::vector<double> movingAverage(const std::vector<double>& in, size_t period, size_t first = 0)
+    {
+        size_t n = in.size();
+        std::vector<double> out(n, NOT_READY);
+        if (period == 0 || first + period > n) return out;
+
+        std::vector<double> prefix(n + 1, 0.0);
+        for (size_t i = first; i < n; i++) prefix[i + 1] = prefix[i] + in[i];
+
+        const double scale = 1.0 / period;
+        const double* upper = prefix.data() + first + period;
+        const double* lower = prefix.data() + first;
+        double* target = out.data() + first + period - 1;
+        size_t count = n - (first + period - 1);
+        for (size_t i = 0; i < count; i++) target[i] = (upper[i] - lower[i]) * scale;
+        return out;
+    }
+
+    // Population standard deviation over the same windows as movingAverage,
+    // from prefix sums of the values and their squares. Values are taken
+    // relative to the first one so large prices do not cancel
+    std::vector<double> movingStdDev(const std::vector<double>& in, size_t period)
+    {
+        size_t n = in.size();
+        std::vector<double> out(n, NOT_READY);
+        if (period == 0 || period > n) return out;
+
+        const double shift = in[0];
+        std::vector<double> sums(n + 1, 0.0), squares(n + 1, 0.0);
+        for (size_t i = 0; i < n; i++)
+        {
+            double value = in[i] - shift;
+            sums[i + 1] = sums[i] + value;
+            squares[i + 1] = squares[i] + value * value;
+        }
+
+        const double scale = 1.0 / period;
+        for (size_t i = period - 1; i < n; i++)
+        {
+            double mean = (sums[i + 1] - sums[i + 1 - period]) * scale;
+            double variance = (squares[i + 1] - squares[i + 1 - period]) * scale - mean * mean;
+            out[i] = variance > 0.0 ? std::sqrt(variance) : 0.0;
+        }
+        return out;
+    }
+
+    // EMA seeded with the SMA of in[first .. first+period-1]
+    std::vector<double> exponentialAverage(const std::vector<double>& in, size_t period, size_t first = 0)
+    {
+        size_t n = in.size();
+        std::vector<double> out(n, NOT_READY);
+        if (period == 0 || first + period > n) return out;
+
+        double value = 0.0;
+        for (size_t i = first; i < first + period; i++) value += in[i];
+        value /= period;
+        out[first + period - 1] = value;
+
+        const double alpha = 2.0 / (period + 1.0);
+        for (size_t i = first + period; i < n; i++)
+        {
+            value += alpha * (in[i] - value);
+            out[i] = value;
+        }
+        return out;
+    }
+
+    // Wilder smoothing from in[first]: plain average of the first 'period', then
+    // (previous * (period - 1) + x) / period
+    std::vector<double> wilderAverage(const std::vector<double>& in, size_t period, size_t first)
+    {
+        size_t n = in.size();
+        std::vector<double> out(n, NOT_READY);
+        if (period == 0 || first + period > n) return out;
+
+        double value = 0.0;
+        for (size_t i = first; i < first + period; i++) value += in[i] / period;
+        out[first + period - 1] = value;
+
+        for (size_t i = first + period; i < n; i++)
+        {
+            value = (value * (period - 1) + in[i]) / period;
+            out[i] = value;
+        }
+        return out;
+    }
+
+    std::string formatName(const std::string& prefix, std::initializer_list<double> args, const std::string& suffix = "")
+    {
+        std::ostringstream oss;
+        oss << prefix << "(";
+        bool firstArg = true;
+        for (double arg : args)
+        {
+            if (!firstArg) oss << ",";
+            oss << arg;
+            firstArg = false;
+        }
+        oss << ")" << suffix;
+        return oss.str();
+    }
+}
+
+// ==================== CONFIGURATION ====================
+
+IndicatorEngine IndicatorEngine::standard()
+{
+    IndicatorEngine engine;
+    engine.addSMA(20);
+    engine.addEMA(20);
+    engine.addRSI(14);
+    engine.addBollinger(20, 2.0);
+    engine.addMACD(12, 26, 9);
+    engine.addATR(14);
+    return engine;
+}
+
+void IndicatorEngine::addSMA(size_t period)
+{
+    specs.push_back(Spec{ Kind::sma, period, 0, 0, 0.0, smas.size() });
+    smas.push_back(MovingAverage(period));
+    names.push_back(formatName("SMA", { (double)period }));
+}
+
+void IndicatorEngine::addEMA(size_t period)
+{
+    specs.push_back(Spec{ Kind::ema, period, 0, 0, 0.0, emas.size() });
+    emas.push_back(ExponentialAverage(period));
+    names.push_back(formatName("EMA", { (double)period }));
+}
+
+void IndicatorEngine::addRSI(size_t period)
+{
+    specs.push_back(Spec{ Kind::rsi, period, 0, 0, 0.0, rsis.size() });
+    rsis.push_back(RelativeStrength(period));
+    names.push_back(formatName("RSI", { (double)period }));
+}
+
+void IndicatorEngine::addBollinger(size_t period, double width)
+{
+    specs.push_back(Spec{ Kind::bollinger, period, 0, 0, width, bands.size() });
+    bands.push_back(BollingerBands(period, width));
+    for (const char* band : { ".upper", ".middle", ".lower" })
+    {
+        names.push_back(formatName("BB", { (double)period, width }, band));
+    }
+}
+
+void IndicatorEngine::addMACD(size_t fastPeriod, size_t slowPeriod, size_t signalPeriod)
+{
+    specs.push_back(Spec{ Kind::macd, fastPeriod, slowPeriod, signalPeriod, 0.0, macds.size() });
+    macds.push_back(MACD(fastPeriod, slowPeriod, signalPeriod));
+    for (const char* line : { "", ".signal", ".histogram" })
+    {
+        names.push_back(formatName("MACD", { (double)fastPeriod, (double)slowPeriod, (double)signalPeriod }, line));
+    }
+}
+
+void IndicatorEngine::addATR(size_t period)
+{
+    specs.push_back(Spec{ Kind::atr, period, 0, 0, 0.0, atrs.size() });
+    atrs.push_back(AverageTrueRange(period));
+    names.push_back(formatName("ATR", { (double)period }));
+}
+
+// ==================== INCREMENTAL ====================
+
+void IndicatorEngine::update(double high, double low, double close)
+{
+    for (MovingAverage& sma : smas) sma.update(close);
+    for (ExponentialAverage& ema : emas) ema.update(close);
+    for (RelativeStrength& rsi : rsis) rsi.update(close);
+    for (BollingerBands& band : bands) band.update(close);
+    for (MACD& macd : macds) macd.update(close);
+    for (AverageTrueRange& atr : atrs) atr.update(high, low, close);
+}
+
+void IndicatorEngine::update(const CandleSeries& series, size_t index)
+{
+    update(series.getHigh(index), series.getLow(index), series.getClose(index));
+}
+
+std::vector<double> IndicatorEngine::getValues() const
+{
+    std::vector<double> values;
+    values.reserve(names.size());
+    for (const Spec& spec : specs)
+    {
+        switch (spec.kind)
+        {
+        case Kind::sma:
+            values.push_back(smas[spec.index].getValue());
+            break;
+        case Kind::ema:
+            values.push_back(emas[spec.index].getValue());
+            break;
+        case Kind::rsi:
+            values.push_back(rsis[spec.index].getValue());
+            break;
+        case Kind::bollinger:
+            values.push_back(bands[spec.index].getUpper());
+            values.push_back(bands[spec.index].getMiddle());
+            values.push_back(bands[spec.index].getLower());
+            break;
+        case Kind::macd:
+            values.push_back(macds[spec.index].getMACD());
+            values.push_back(macds[spec.index].getSignal());
+            values.push_back(macds[spec.index].getHistogram());
+            break;
+        case Kind::atr:
+            values.push_back(atrs[spec.index].getValue());
+            break;
+        }
+    }
+    return values;
+}
+
+// ==================== BATCH ====================
+
+std::vector<std::vector<double>> IndicatorEngine::compute(const CandleSeries& series) const
+{
+    const std::vector<double>& closes = series.getCloses();
+    const std::vector<double>& highs = series.getHighs();
+    const std::vector<double>& lows = series.getLows();
+    size_t n = closes.size();
+
+    std::vector<std::vector<double>> columns;
+    columns.reserve(names.size());
+
+    for (const Spec& spec : specs)
+    {
+        switch (spec.kind)
+        {
+        case Kind::sma:
+            columns.push_back(movingAverage(closes, spec.period));
+            break;
+
+        case Kind::ema:
+            columns.push_back(exponentialAverage(closes, spec.period));
+            break;
+
+        case Kind::rsi:
+        {
+            // Gains and losses of each change, then Wilder-smoothed
+            std::vector<double> gains(n, 0.0), losses(n, 0.0);
+            for (size_t i = 1; i < n; i++)
+            {
+                double change = closes[i] - closes[i - 1];
+                gains[i] = change > 0.0 ? change : 0.0;
+                losses[i] = change < 0.0 ? -change : 0.0;
+            }
+            std::vector<double> gain = wilderAverage(gains, spec.period, 1);
+            std::vector<double> loss = wilderAverage(losses, spec.period, 1);
+
+            std::vector<double> rsi(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                double ratio = 100.0 - 100.0 / (1.0 + gain[i] / loss[i]);
+                rsi[i] = (loss[i] == 0.0) ? (gain[i] == 0.0 ? 50.0 : 100.0) : ratio;
+                if (std::isnan(gain[i])) rsi[i] = NOT_READY;
+            }
+            columns.push_back(rsi);
+            break;
+        }
+
+        case Kind::bollinger:
+        {
+            std::vector<double> middle = movingAverage(closes, spec.period);
+            std::vector<double> deviation = movingStdDev(closes, spec.period);
+            std::vector<double> upper(n), lower(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                upper[i] = middle[i] + spec.width * deviation[i];
+                lower[i] = middle[i] - spec.width * deviation[i];
+            }
+            columns.push_back(upper);
+            columns.push_back(middle);
+            columns.push_back(lower);
+            break;
+        }
+
+        case Kind::macd:
+        {
+            std::vector<double> fast = exponentialAverage(closes, spec.period);
+            std::vector<double> slow = exponentialAverage(closes, spec.slow);
+            std::vector<double> line(n);
+            for (size_t i = 0; i < n; i++) line[i] = fast[i] - slow[i];
+
+            // The signal line starts once both averages are warm
+            size_t first = (spec.period > spec.slow ? spec.period : spec.slow);
+            first = first > 0 ? first - 1 : 0;
+            std::vector<double> signal = exponentialAverage(line, spec.signal, first);
+            std::vector<double> histogram(n);
+            for (size_t i = 0; i < n; i++) histogram[i] = line[i] - signal[i];
+
+            columns.push_back(line);
+            columns.push_back(signal);
+            columns.push_back(histogram);
+            break;
+        }
+
+        case Kind::atr:
+        {
+            std::vector<double> ranges(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                double range = highs[i] - lows[i];
+                if (i > 0)
+                {
+                    range = std::fmax(range, std::fmax(std::fabs(highs[i] - closes[i - 1]),
+                        std::fabs(lows[i] - closes[i - 1])));
+                }
+                ranges[i] = range;
+            }
+            columns.push_back(wilderAverage(ranges, spec.period, 0));
+            break;
+        }
+        }
+    }
+    return columns;
+}
@@ -0,0 +1,62 @@
+// ==================== IndicatorEngine.h ====================
+/**
+ * IndicatorEngine.h
+ * A configurable set of technical indicators over one candle series
+ * TASK 1: update() advances every indicator by one closed candle in O(1)
+ * each; compute() evaluates a whole history with array kernels instead of
+ * feeding candles one at a time
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "CandleSeries.h"
+#include "Indicators.h"
+
+class IndicatorEngine
+{
+public:
+    // SMA(20), EMA(20), RSI(14), BB(20,2), MACD(12,26,9), ATR(14)
+    static IndicatorEngine standard();
+
+    void addSMA(size_t period);
+    void addEMA(size_t period);
+    void addRSI(size_t period);
+    void addBollinger(size_t period, double width);
+    void addMACD(size_t fastPeriod, size_t slowPeriod, size_t signalPeriod);
+    void addATR(size_t period);
+
+    // One output name per value, e.g. "BB(20,2).upper"
+    const std::vector<std::string>& getNames() const { return names; }
+
+    // Incremental: advance by one closed candle, then read the latest values
+    void update(double high, double low, double close);
+    void update(const CandleSeries& series, size_t index);
+    std::vector<double> getValues() const;
+
+    // Batch: one column per name, one row per candle (NaN while warming up)
+    std::vector<std::vector<double>> compute(const CandleSeries& series) const;
+
+private:
+    enum class Kind { sma, ema, rsi, bollinger, macd, atr };
+
+    struct Spec
+    {
+        Kind kind;
+        size_t period;     // Fast period for MACD
+        size_t slow;       // MACD only
+        size_t signal;     // MACD only
+        double width;      // Bollinger only
+        size_t index;      // Into the matching state vector
+    };
+
+    std::vector<Spec> specs;
+    std::vector<std::string> names;
+
+    std::vector<MovingAverage> smas;
+    std::vector<ExponentialAverage> emas;
+    std::vector<RelativeStrength> rsis;
+    std::vector<BollingerBands> bands;
+    std::vector<MACD> macds;
+    std::vector<AverageTrueRange> atrs;
+};
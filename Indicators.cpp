@@ -0,0 +1,263 @@
+// ==================== Indicators.cpp ====================
+/**
+ * Indicators.cpp
+ * Implementation of the rolling technical indicators
+ */
+
+#include "Indicators.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double NOT_READY = std::numeric_limits<double>::quiet_NaN();
+}
+
+// ==================== MOVING AVERAGE ====================
+
+MovingAverage::MovingAverage(size_t _period)
+    : period(_period > 0 ? _period : 1),
+    window(period, 0.0),
+    next(0),
+    count(0),
+    shift(0.0),
+    sum(0.0),
+    sumSquares(0.0)
+{
+}
+
+void MovingAverage::update(double value)
+{
+    if (count == 0)
+    {
+        shift = value;
+    }
+    value -= shift;
+
+    // Drop the value leaving the window, add the new one
+    double& slot = window[next];
+    if (count >= period)
+    {
+        sum -= slot;
+        sumSquares -= slot * slot;
+    }
+    slot = value;
+    sum += value;
+    sumSquares += value * value;
+    next = (next + 1) % period;
+    count++;
+
+    // Once per full window: amortised O(1), stops rounding error building up
+    if (next == 0)
+    {
+        recentre();
+    }
+}
+
+void MovingAverage::recentre()
+{
+    size_t filled = count < period ? count : period;
+    double mean = sum / filled;
+
+    shift += mean;
+    sum = 0.0;
+    sumSquares = 0.0;
+    for (size_t i = 0; i < filled; i++)
+    {
+        window[i] -= mean;
+        sum += window[i];
+        sumSquares += window[i] * window[i];
+    }
+}
+
+double MovingAverage::getValue() const
+{
+    return isReady() ? shift + sum / period : NOT_READY;
+}
+
+double MovingAverage::getStdDev() const
+{
+    if (!isReady()) return NOT_READY;
+    double mean = sum / period;
+    double variance = sumSquares / period - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+// ==================== EXPONENTIAL AVERAGE ====================
+
+ExponentialAverage::ExponentialAverage(size_t _period)
+    : period(_period > 0 ? _period : 1),
+    alpha(2.0 / (period + 1.0)),
+    count(0),
+    seedSum(0.0),
+    value(0.0)
+{
+}
+
+void ExponentialAverage::update(double input)
+{
+    count++;
+    if (count < period)
+    {
+        seedSum += input;
+    }
+    else if (count == period)
+    {
+        value = (seedSum + input) / period;
+    }
+    else
+    {
+        value += alpha * (input - value);
+    }
+}
+
+double ExponentialAverage::getValue() const
+{
+    return isReady() ? value : NOT_READY;
+}
+
+// ==================== RELATIVE STRENGTH ====================
+
+RelativeStrength::RelativeStrength(size_t _period)
+    : period(_period > 0 ? _period : 1),
+    changes(0),
+    hasPrevious(false),
+    previous(0.0),
+    averageGain(0.0),
+    averageLoss(0.0)
+{
+}
+
+void RelativeStrength::update(double close)
+{
+    if (!hasPrevious)
+    {
+        previous = close;
+        hasPrevious = true;
+        return;
+    }
+
+    double change = close - previous;
+    double gain = change > 0.0 ? change : 0.0;
+    double loss = change < 0.0 ? -change : 0.0;
+    previous = close;
+    changes++;
+
+    if (changes <= period)
+    {
+        // Seed with plain averages of the first 'period' changes
+        averageGain += gain / period;
+        averageLoss += loss / period;
+    }
+    else
+    {
+        averageGain = (averageGain * (period - 1) + gain) / period;
+        averageLoss = (averageLoss * (period - 1) + loss) / period;
+    }
+}
+
+double RelativeStrength::getValue() const
+{
+    if (!isReady()) return NOT_READY;
+    if (averageLoss == 0.0) return averageGain == 0.0 ? 50.0 : 100.0;
+    return 100.0 - 100.0 / (1.0 + averageGain / averageLoss);
+}
+
+// ==================== BOLLINGER BANDS ====================
+
+BollingerBands::BollingerBands(size_t _period, double _width)
+    : average(_period),
+    width(_width)
+{
+}
+
+void BollingerBands::update(double close)
+{
+    average.update(close);
+}
+
+double BollingerBands::getMiddle() const
+{
+    return average.getValue();
+}
+
+double BollingerBands::getUpper() const
+{
+    return average.getValue() + width * average.getStdDev();
+}
+
+double BollingerBands::getLower() const
+{
+    return average.getValue() - width * average.getStdDev();
+}
+
+// ==================== MACD ====================
+
+MACD::MACD(size_t fastPeriod, size_t slowPeriod, size_t signalPeriod)
+    : fast(fastPeriod),
+    slow(slowPeriod),
+    signal(signalPeriod)
+{
+}
+
+void MACD::update(double close)
+{
+    fast.update(close);
+    slow.update(close);
+    if (fast.isReady() && slow.isReady())
+    {
+        signal.update(fast.getValue() - slow.getValue());
+    }
+}
+
+double MACD::getMACD() const
+{
+    return slow.isReady() ? fast.getValue() - slow.getValue() : NOT_READY;
+}
+
+double MACD::getSignal() const
+{
+    return signal.getValue();
+}
+
+double MACD::getHistogram() const
+{
+    return getMACD() - getSignal();
+}
+
+// ==================== AVERAGE TRUE RANGE ====================
+
+AverageTrueRange::AverageTrueRange(size_t _period)
+    : period(_period > 0 ? _period : 1),
+    count(0),
+    hasPrevious(false),
+    previousClose(0.0),
+    value(0.0)
+{
+}
+
+void AverageTrueRange::update(double high, double low, double close)
+{
+    double range = high - low;
+    if (hasPrevious)
+    {
+        range = std::fmax(range, std::fmax(std::fabs(high - previousClose), std::fabs(low - previousClose)));
+    }
+    previousClose = close;
+    hasPrevious = true;
+    count++;
+
+    if (count <= period)
+    {
+        value += range / period;
+    }
+    else
+    {
+        value = (value * (period - 1) + range) / period;
+    }
+}
+
+double AverageTrueRange::getValue() const
+{
+    return isReady() ? value : NOT_READY;
+}
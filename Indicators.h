@@ -0,0 +1,120 @@
+// ==================== Indicators.h ====================
+/**
+ * Indicators.h
+ * Technical indicators with rolling state
+ * TASK 1: Each update() takes one closed candle and costs O(1), whatever
+ * the period; values are NaN until the indicator has enough candles
+ */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Simple moving average of the last 'period' values
+class MovingAverage
+{
+public:
+    explicit MovingAverage(size_t _period);
+    void update(double value);
+    bool isReady() const { return count >= period; }
+    double getValue() const;
+
+    // Population standard deviation over the same window
+    double getStdDev() const;
+
+private:
+    size_t period;
+    void recentre();
+
+    std::vector<double> window;   // Ring buffer, stored relative to 'shift'
+    size_t next;
+    size_t count;
+    double shift;                 // Recent mean; keeps the squares small
+    double sum;
+    double sumSquares;
+};
+
+// Exponential moving average, seeded with the SMA of the first 'period' values
+class ExponentialAverage
+{
+public:
+    explicit ExponentialAverage(size_t _period);
+    void update(double value);
+    bool isReady() const { return count >= period; }
+    double getValue() const;
+
+private:
+    size_t period;
+    double alpha;
+    size_t count;
+    double seedSum;
+    double value;
+};
+
+// Wilder's relative strength index (0-100)
+class RelativeStrength
+{
+public:
+    explicit RelativeStrength(size_t _period);
+    void update(double close);
+    bool isReady() const { return changes >= period; }
+    double getValue() const;
+
+private:
+    size_t period;
+    size_t changes;
+    bool hasPrevious;
+    double previous;
+    double averageGain;
+    double averageLoss;
+};
+
+// Middle band = SMA, outer bands = SMA +/- width * standard deviation
+class BollingerBands
+{
+public:
+    BollingerBands(size_t _period, double _width);
+    void update(double close);
+    bool isReady() const { return average.isReady(); }
+    double getMiddle() const;
+    double getUpper() const;
+    double getLower() const;
+
+private:
+    MovingAverage average;
+    double width;
+};
+
+// MACD line = fast EMA - slow EMA; signal = EMA of the MACD line
+class MACD
+{
+public:
+    MACD(size_t fastPeriod, size_t slowPeriod, size_t signalPeriod);
+    void update(double close);
+    bool isReady() const { return signal.isReady(); }
+    double getMACD() const;
+    double getSignal() const;
+    double getHistogram() const;
+
+private:
+    ExponentialAverage fast;
+    ExponentialAverage slow;
+    ExponentialAverage signal;
+};
+
+// Wilder's average true range
+class AverageTrueRange
+{
+public:
+    explicit AverageTrueRange(size_t _period);
+    void update(double high, double low, double close);
+    bool isReady() const { return count >= period; }
+    double getValue() const;
+
+private:
+    size_t period;
+    size_t count;
+    bool hasPrevious;
+    double previousClose;
+    double value;
+};
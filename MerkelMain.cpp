@@ -1,1180 +1,1665 @@
-﻿// ==================== MerkelMain.cpp ====================
-/**
- * MerkelMain.cpp
- * Implementation of main application controller
- * Handles all user interactions, trading operations, and data management
- */
-
-#include "MerkelMain.h"
-#include "CSVReader.h"
-#include <iostream>
-#include <iomanip>
-#include <limits>
-#include <chrono>
-#include <ctime>
-#include <regex>
-#include <algorithm>
-
-MerkelMain::MerkelMain()
-    : orderBook("20200317.csv"), isAuthenticated(false)
-{
-    currentTime = orderBook.getEarliestTime();
-}
-
-void MerkelMain::init()
-{
-    std::cout << "========================================" << std::endl;
-    std::cout << "  CRYPTOCURRENCY TRADING SIMULATOR" << std::endl;
-    std::cout << "  Technical Analysis Toolkit" << std::endl;
-    std::cout << "========================================" << std::endl;
-    std::cout << std::endl;
-
-    // Force login/register before accessing main features
-    while (!isLoggedIn())
-    {
-        loginOrRegister();
-    }
-
-    // Load user's wallet after successful login
-    loadUserWallet();
-
-    // Main application loop
-    int input;
-    while (true)
-    {
-        printMainMenu();
-        input = getUserOption();
-        processUserOption(input);
-    }
-}
-
-// ==================== MENU FUNCTIONS ====================
-
-void MerkelMain::printMainMenu()
-{
-    std::cout << "\n========================================" << std::endl;
-    std::cout << "  MAIN MENU - Welcome " << currentUser.getFullName() << std::endl;
-    std::cout << "========================================" << std::endl;
-    std::cout << "1: View Candlestick Data (Technical Analysis)" << std::endl;
-    std::cout << "2: Manage Wallet & View Balance" << std::endl;
-    std::cout << "3: View Transaction History" << std::endl;
-    std::cout << "4: View Trading Statistics" << std::endl;
-    std::cout << "5: Place Ask (Sell Order)" << std::endl;
-    std::cout << "6: Place Bid (Buy Order)" << std::endl;
-    std::cout << "7: Simulate Trading Activity" << std::endl;
-    std::cout << "8: View Market Statistics" << std::endl;
-    std::cout << "9: Help" << std::endl;
-    std::cout << "10: Logout" << std::endl;
-    std::cout << "========================================" << std::endl;
-    std::cout << "Current Time: " << currentTime << std::endl;
-    std::cout << "========================================" << std::endl;
-}
-
-void MerkelMain::printHelpMenu()
-{
-    std::cout << "\n========== HELP MENU ==========" << std::endl;
-    std::cout << "This is a cryptocurrency trading simulator with technical analysis tools." << std::endl;
-    std::cout << "\nFeatures:" << std::endl;
-    std::cout << "- Candlestick Analysis: View OHLC data for any product and timeframe" << std::endl;
-    std::cout << "- Wallet Management: Deposit, withdraw, and track your funds" << std::endl;
-    std::cout << "- Trading: Place ask (sell) and bid (buy) orders" << std::endl;
-    std::cout << "- History: View all your past transactions and statistics" << std::endl;
-    std::cout << "\nGoal: Analyze market trends and make profitable trades!" << std::endl;
-    std::cout << "================================" << std::endl;
-}
-
-int MerkelMain::getUserOption()
-{
-    int userOption = 0;
-    std::string line;
-    std::cout << "\nEnter your choice (1-10): ";
-
-    while (true)
-    {
-        std::getline(std::cin, line);
-
-        if (line.empty())
-        {
-            std::cout << "Input cannot be empty. Please enter a number (1-10): ";
-            continue;
-        }
-
-        // Check if input is numeric
-        bool isNumeric = true;
-        for (char c : line)
-        {
-            if (!isdigit(c))
-            {
-                isNumeric = false;
-                break;
-            }
-        }
-
-        if (!isNumeric)
-        {
-            std::cout << "Invalid input. Please enter a valid number (1-10): ";
-            continue;
-        }
-
-        try
-        {
-            userOption = std::stoi(line);
-
-            if (userOption < 1 || userOption > 10)
-            {
-                std::cout << "Invalid choice. Please enter a number between 1-10: ";
-                continue;
-            }
-
-            break;
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "Invalid input. Please enter a number (1-10): ";
-        }
-    }
-
-    return userOption;
-}
-
-void MerkelMain::processUserOption(int userOption)
-{
-    switch (userOption)
-    {
-    case 1:
-        displayCandlestickData();
-        break;
-    case 2:
-        manageWallet();
-        break;
-    case 3:
-        viewTransactionHistory();
-        break;
-    case 4:
-        viewUserStatistics();
-        break;
-    case 5:
-        placeAsk();
-        break;
-    case 6:
-        placeBid();
-        break;
-    case 7:
-        simulateTrading();
-        break;
-    case 8:
-        printMarketStats();
-        break;
-    case 9:
-        printHelpMenu();
-        break;
-    case 10:
-        std::cout << "\nLogging out... Goodbye!" << std::endl;
-        currentUser = User();
-        isAuthenticated = false;
-        exit(0);
-        break;
-    default:
-        std::cout << "Invalid option." << std::endl;
-    }
-}
-
-// ==================== TASK 1: CANDLESTICK DATA ====================
-
-void MerkelMain::displayCandlestickData()
-{
-    std::cout << "\n========== CANDLESTICK TECHNICAL ANALYSIS ==========" << std::endl;
-
-    std::string product = getValidatedProductInput();
-
-    // Get time period selection
-    std::cout << "\nSelect time period:" << std::endl;
-    std::cout << "1: Daily" << std::endl;
-    std::cout << "2: Monthly" << std::endl;
-    std::cout << "3: Yearly (default)" << std::endl;
-    int periodChoice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
-
-    std::string period = "yearly";
-    if (periodChoice == 1) period = "daily";
-    else if (periodChoice == 2) period = "monthly";
-
-    std::cout << "\nGenerating candlestick data for " << product << " (" << period << ")..." << std::endl;
-
-    // Generate candlesticks for asks (sell orders)
-    std::vector<OrderBookEntry> allOrders = orderBook.getOrders(OrderBookType::ask, product, currentTime);
-    std::vector<Candlestick> askCandlesticks = dataManager.generateCandlesticks(
-        allOrders, product, period, OrderBookType::ask);
-
-    // Generate candlesticks for bids (buy orders)
-    allOrders = orderBook.getOrders(OrderBookType::bid, product, currentTime);
-    std::vector<Candlestick> bidCandlesticks = dataManager.generateCandlesticks(
-        allOrders, product, period, OrderBookType::bid);
-
-    // Display results
-    std::cout << "\n========== ASK (SELL) ORDERS ==========" << std::endl;
-    printCandlestickTable(askCandlesticks, "ASK");
-
-    std::cout << "\n========== BID (BUY) ORDERS ==========" << std::endl;
-    printCandlestickTable(bidCandlesticks, "BID");
-}
-
-void MerkelMain::printCandlestickTable(const std::vector<Candlestick>& candlesticks, std::string type)
-{
-    if (candlesticks.empty())
-    {
-        std::cout << "No data available for this product." << std::endl;
-        return;
-    }
-
-    // Print table header
-    std::cout << std::left << std::setw(15) << "Date"
-        << std::right << std::setw(12) << "Open"
-        << std::setw(12) << "High"
-        << std::setw(12) << "Low"
-        << std::setw(12) << "Close" << std::endl;
-    std::cout << std::string(63, '-') << std::endl;
-
-    // Print each candlestick
-    for (const Candlestick& candle : candlesticks)
-    {
-        std::cout << std::fixed << std::setprecision(6);
-        std::cout << std::left << std::setw(15) << candle.getDate()
-            << std::right << std::setw(12) << candle.getOpen()
-            << std::setw(12) << candle.getHigh()
-            << std::setw(12) << candle.getLow()
-            << std::setw(12) << candle.getClose() << std::endl;
-    }
-
-    std::cout << "\nTotal records: " << candlesticks.size() << std::endl;
-}
-
-// ==================== TASK 2: USER AUTHENTICATION ====================
-
-void MerkelMain::loginOrRegister()
-{
-    std::cout << "\n========== AUTHENTICATION ==========" << std::endl;
-    std::cout << "1: Login" << std::endl;
-    std::cout << "2: Register" << std::endl;
-    std::cout << "3: Forgot Password" << std::endl;
-
-    int choice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
-
-    if (choice == 1)
-    {
-        loginUser();
-    }
-    else if (choice == 2)
-    {
-        registerNewUser();
-    }
-    else if (choice == 3)
-    {
-        forgotPassword();
-    }
-}
-
-void MerkelMain::registerNewUser()
-{
-    std::cout << "\n========== USER REGISTRATION ==========" << std::endl;
-
-    std::string fullName = getValidatedStringInput("Enter full name: ");
-
-    // Email validation loop
-    std::string email;
-    while (true)
-    {
-        email = getValidatedStringInput("Enter email address: ");
-        if (validateEmail(email))
-        {
-            break;
-        }
-        std::cout << "Invalid email format. Please try again." << std::endl;
-    }
-
-    // Check for duplicate users
-    if (dataManager.userExists(email, fullName))
-    {
-        std::cout << "\nUser with this email and name already exists!" << std::endl;
-        std::cout << "Please login instead or use a different email." << std::endl;
-        return;
-    }
-
-    std::string password = getValidatedStringInput("Enter password: ");
-    std::string confirmPassword = getValidatedStringInput("Confirm password: ");
-
-    if (password != confirmPassword)
-    {
-        std::cout << "Passwords do not match. Registration failed." << std::endl;
-        return;
-    }
-
-    // Generate unique username and hash password
-    std::string username = User::generateUsername();
-    std::string passwordHash = User::hashPassword(password);
-
-    // Create and save user
-    User newUser(username, fullName, email, passwordHash);
-    if (dataManager.saveUser(newUser))
-    {
-        std::cout << "\n========== REGISTRATION SUCCESSFUL ==========" << std::endl;
-        std::cout << "Your username is: " << username << std::endl;
-        std::cout << "Please save this for future logins!" << std::endl;
-        std::cout << "=============================================" << std::endl;
-
-        // Auto-login
-        currentUser = newUser;
-        isAuthenticated = true;
-
-        // Initialize wallet with starting balance
-        wallet.insertCurrency("USDT", 10000.0);
-        wallet.insertCurrency("BTC", 0.5);
-        wallet.insertCurrency("ETH", 5.0);
-        saveCurrentWalletState();
-    }
-    else
-    {
-        std::cout << "Registration failed. Please try again." << std::endl;
-    }
-}
-
-void MerkelMain::loginUser()
-{
-    std::cout << "\n========== USER LOGIN ==========" << std::endl;
-
-    std::string username = getValidatedStringInput("Enter username (10 digits): ");
-    std::string password = getValidatedStringInput("Enter password: ");
-
-    // Load user from database
-    User user = dataManager.loadUser(username);
-
-    if (user.getUsername().empty())
-    {
-        std::cout << "User not found. Please check your username or register." << std::endl;
-        return;
-    }
-
-    // Verify password by comparing hashes
-    std::string passwordHash = User::hashPassword(password);
-    if (passwordHash == user.getPasswordHash())
-    {
-        std::cout << "\n========== LOGIN SUCCESSFUL ==========" << std::endl;
-        std::cout << "Welcome back, " << user.getFullName() << "!" << std::endl;
-        std::cout << "======================================" << std::endl;
-        currentUser = user;
-        isAuthenticated = true;
-    }
-    else
-    {
-        std::cout << "Incorrect password. Login failed." << std::endl;
-    }
-}
-
-void MerkelMain::forgotPassword()
-{
-    std::cout << "\n========== PASSWORD RECOVERY ==========" << std::endl;
-
-    std::string email = getValidatedStringInput("Enter your registered email: ");
-
-    User user = dataManager.getUserByEmail(email);
-
-    if (user.getUsername().empty())
-    {
-        std::cout << "No account found with this email." << std::endl;
-        return;
-    }
-
-    std::cout << "\nAccount found!" << std::endl;
-    std::cout << "Username: " << user.getUsername() << std::endl;
-    std::cout << "Full Name: " << user.getFullName() << std::endl;
-
-    std::cout << "\nWould you like to reset your password? (yes/no): ";
-    std::string response;
-    std::getline(std::cin, response);
-
-    if (response == "yes" || response == "y" || response == "Yes")
-    {
-        std::string newPassword = getValidatedStringInput("Enter new password: ");
-        std::string confirmPassword = getValidatedStringInput("Confirm new password: ");
-
-        if (newPassword != confirmPassword)
-        {
-            std::cout << "Passwords do not match. Reset failed." << std::endl;
-            return;
-        }
-
-        std::cout << "\nPassword reset successful! Please login with your new password." << std::endl;
-    }
-}
-
-// ==================== TASK 3: WALLET & TRANSACTION HISTORY ====================
-
-void MerkelMain::manageWallet()
-{
-    std::cout << "\n========== WALLET MANAGEMENT ==========" << std::endl;
-    std::cout << "1: View Balance" << std::endl;
-    std::cout << "2: Deposit Funds" << std::endl;
-    std::cout << "3: Withdraw Funds" << std::endl;
-
-    int choice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
-
-    if (choice == 1)
-    {
-        viewWalletBalance();
-    }
-    else if (choice == 2)
-    {
-        depositFunds();
-    }
-    else if (choice == 3)
-    {
-        withdrawFunds();
-    }
-}
-
-void MerkelMain::depositFunds()
-{
-    std::cout << "\n========== DEPOSIT FUNDS ==========" << std::endl;
-
-    // TASK 5: Currency validation
-    std::string currency = getValidatedCurrencyInput("Select a currency to deposit");
-
-    // TASK 5: Amount validation with limits
-    double amount = 0.0;
-    while (true)
-    {
-        amount = getValidatedDoubleInput("Enter amount to deposit: ");
-
-        if (amount <= 0)
-        {
-            std::cout << "Amount must be positive. Please try again." << std::endl;
-            continue;
-        }
-
-        if (amount > 1000000000.0)
-        {
-            std::cout << "Amount too large. Maximum deposit is 1,000,000,000. Please try again." << std::endl;
-            continue;
-        }
-
-        break;
-    }
-
-    // Get current balance
-    double currentBalance = 0.0;
-    if (wallet.containsCurrency(currency, 0))
-    {
-        std::string walletStr = wallet.toString();
-        std::istringstream iss(walletStr);
-        std::string line;
-
-        while (std::getline(iss, line))
-        {
-            if (line.find(currency) != std::string::npos)
-            {
-                size_t colonPos = line.find(':');
-                if (colonPos != std::string::npos)
-                {
-                    std::string amountStr = line.substr(colonPos + 2);
-                    amountStr.erase(std::remove_if(amountStr.begin(), amountStr.end(), ::isspace),
-                        amountStr.end());
-                    try {
-                        currentBalance = std::stod(amountStr);
-                    }
-                    catch (...) {
-                        currentBalance = 0.0;
-                    }
-                }
-                break;
-            }
-        }
-    }
-
-    wallet.insertCurrency(currency, amount);
-    saveCurrentWalletState();
-
-    // Log transaction
-    std::string timestamp = getCurrentTimestamp();
-    double newBalance = currentBalance + amount;
-    Transaction trans(currentUser.getUsername(), timestamp, TransactionType::DEPOSIT,
-        currency, amount, 0.0, newBalance);
-    dataManager.saveTransaction(trans);
-
-    std::cout << "\nDeposit successful!" << std::endl;
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "New " << currency << " balance: " << newBalance << std::endl;
-}
-
-void MerkelMain::withdrawFunds()
-{
-    std::cout << "\n========== WITHDRAW FUNDS ==========" << std::endl;
-
-    // TASK 5: Currency validation
-    std::string currency = getValidatedCurrencyInput("Select a currency to withdraw");
-
-    if (!wallet.containsCurrency(currency, 0))
-    {
-        std::cout << "You don't have any " << currency << " in your wallet." << std::endl;
-        return;
-    }
-
-    // TASK 5: Amount validation with limits
-    double amount = 0.0;
-    while (true)
-    {
-        amount = getValidatedDoubleInput("Enter amount to withdraw: ");
-
-        if (amount <= 0)
-        {
-            std::cout << "Amount must be positive. Please try again." << std::endl;
-            continue;
-        }
-
-        if (amount > 1000000000.0)
-        {
-            std::cout << "Amount too large. Maximum withdrawal is 1,000,000,000. Please try again." << std::endl;
-            continue;
-        }
-
-        break;
-    }
-
-    if (!wallet.containsCurrency(currency, amount))
-    {
-        std::cout << "Insufficient funds in wallet." << std::endl;
-        std::cout << "You attempted to withdraw " << amount << " " << currency << std::endl;
-        return;
-    }
-
-    if (wallet.removeCurrency(currency, amount))
-    {
-        saveCurrentWalletState();
-
-        // Log transaction
-        std::string timestamp = getCurrentTimestamp();
-        Transaction trans(currentUser.getUsername(), timestamp, TransactionType::WITHDRAWAL,
-            currency, amount, 0.0, 0.0);
-        dataManager.saveTransaction(trans);
-
-        std::cout << "\nWithdrawal successful!" << std::endl;
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "Withdrew " << amount << " " << currency << std::endl;
-    }
-    else
-    {
-        std::cout << "Withdrawal failed." << std::endl;
-    }
-}
-
-void MerkelMain::viewWalletBalance()
-{
-    std::cout << "\n========== WALLET BALANCE ==========" << std::endl;
-    std::cout << wallet.toString();
-    std::cout << "====================================" << std::endl;
-}
-
-void MerkelMain::viewTransactionHistory()
-{
-    std::cout << "\n========== TRANSACTION HISTORY ==========" << std::endl;
-    std::cout << "1: View all transactions" << std::endl;
-    std::cout << "2: View last 5 transactions" << std::endl;
-    std::cout << "3: View by product" << std::endl;
-
-    int choice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
-
-    std::vector<Transaction> transactions;
-
-    if (choice == 1)
-    {
-        transactions = dataManager.loadUserTransactions(currentUser.getUsername());
-    }
-    else if (choice == 2)
-    {
-        transactions = dataManager.loadUserTransactions(currentUser.getUsername(), 5);
-    }
-    else if (choice == 3)
-    {
-        std::string product = getValidatedStringInput("Enter product (e.g., ETH/USDT): ");
-        transactions = dataManager.loadUserTransactionsByProduct(currentUser.getUsername(), product);
-    }
-
-    if (transactions.empty())
-    {
-        std::cout << "No transactions found." << std::endl;
-        return;
-    }
-
-    std::cout << "\nTransaction History:" << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
-    for (const Transaction& trans : transactions)
-    {
-        std::cout << trans.toString() << std::endl;
-    }
-    std::cout << "\nTotal transactions: " << transactions.size() << std::endl;
-}
-
-void MerkelMain::viewUserStatistics()
-{
-    std::cout << "\n========== USER TRADING STATISTICS ==========" << std::endl;
-
-    std::vector<Transaction> allTransactions = dataManager.loadUserTransactions(currentUser.getUsername());
-
-    if (allTransactions.empty())
-    {
-        std::cout << "No trading activity yet." << std::endl;
-        return;
-    }
-
-    // Calculate statistics
-    int totalAsks = 0, totalBids = 0;
-    double totalMoneySpent = 0.0;
-    std::map<std::string, int> productAsks, productBids;
-
-    for (const Transaction& trans : allTransactions)
-    {
-        TransactionType type = trans.getType();
-        std::string product = trans.getProduct();
-
-        if (type == TransactionType::ASK_PLACED || type == TransactionType::ASK_FILLED)
-        {
-            totalAsks++;
-            productAsks[product]++;
-        }
-        else if (type == TransactionType::BID_PLACED || type == TransactionType::BID_FILLED)
-        {
-            totalBids++;
-            productBids[product]++;
-            totalMoneySpent += trans.getAmount() * trans.getPrice();
-        }
-    }
-
-    std::cout << "Total Transactions: " << allTransactions.size() << std::endl;
-    std::cout << "Total Asks (Sell Orders): " << totalAsks << std::endl;
-    std::cout << "Total Bids (Buy Orders): " << totalBids << std::endl;
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Total Money Spent: " << totalMoneySpent << std::endl;
-
-    std::cout << "\n--- Asks by Product ---" << std::endl;
-    for (const auto& pair : productAsks)
-    {
-        std::cout << pair.first << ": " << pair.second << " asks" << std::endl;
-    }
-
-    std::cout << "\n--- Bids by Product ---" << std::endl;
-    for (const auto& pair : productBids)
-    {
-        std::cout << pair.first << ": " << pair.second << " bids" << std::endl;
-    }
-}
-
-// ==================== TASK 4: TRADING SIMULATION ====================
-
-void MerkelMain::simulateTrading()
-{
-    std::cout << "\n========== SIMULATE TRADING ACTIVITY ==========" << std::endl;
-    std::cout << "This will create 5 ask and 5 bid orders for all products." << std::endl;
-    std::cout << "Continue? (yes/no): ";
-
-    std::string response;
-    std::getline(std::cin, response);
-
-    if (response != "yes" && response != "y")
-    {
-        std::cout << "Simulation cancelled." << std::endl;
-        return;
-    }
-
-    std::vector<std::string> products = orderBook.getKnownProducts();
-    std::string timestamp = getCurrentTimestamp();
-    int ordersCreated = 0;
-
-    for (const std::string& product : products)
-    {
-        // Create 5 ask orders with varying amounts
-        for (int i = 0; i < 5; i++)
-        {
-            double price = calculateAskPrice(product);
-            double amount = 0.1 + (i * 0.05);
-
-            OrderBookEntry obe(price, amount, timestamp, product,
-                OrderBookType::ask, currentUser.getUsername());
-            orderBook.insertOrder(obe);
-
-            Transaction trans(currentUser.getUsername(), timestamp, TransactionType::ASK_PLACED,
-                product, amount, price, 0.0);
-            dataManager.saveTransaction(trans);
-            ordersCreated++;
-        }
-
-        // Create 5 bid orders with varying amounts
-        for (int i = 0; i < 5; i++)
-        {
-            double price = calculateBidPrice(product);
-            double amount = 0.1 + (i * 0.05);
-
-            OrderBookEntry obe(price, amount, timestamp, product,
-                OrderBookType::bid, currentUser.getUsername());
-            orderBook.insertOrder(obe);
-
-            Transaction trans(currentUser.getUsername(), timestamp, TransactionType::BID_PLACED,
-                product, amount, price, 0.0);
-            dataManager.saveTransaction(trans);
-            ordersCreated++;
-        }
-    }
-
-    std::cout << "\nSimulation complete!" << std::endl;
-    std::cout << "Created " << ordersCreated << " orders across " << products.size() << " products." << std::endl;
-    std::cout << "\nNote: Prices calculated using historical data adjusted for time gap." << std::endl;
-}
-
-double MerkelMain::calculateAskPrice(std::string product)
-{
-    // TASK 4: Calculate ask price with 5-year growth adjustment (2020 → 2025)
-    // Historical CSV data is from 2020, current system time is 2025
-    // Apply 15% annual compound growth: 1.15^5 = 2.011x
-
-    // Try to get historical data for this product
-    std::vector<OrderBookEntry> allOrders = orderBook.getOrders(
-        OrderBookType::ask, product, orderBook.getEarliestTime());
-
-    // If no data at earliest time, scan through timeframes
-    if (allOrders.empty())
-    {
-        std::string timestamp = orderBook.getEarliestTime();
-        for (int i = 0; i < 100; i++)
-        {
-            allOrders = orderBook.getOrders(OrderBookType::ask, product, timestamp);
-            if (!allOrders.empty()) break;
-            timestamp = orderBook.getNextTime(timestamp);
-            if (timestamp == orderBook.getEarliestTime()) break;
-        }
-    }
-
-    // Fallback prices for products with no historical data
-    if (allOrders.empty())
-    {
-        if (product.find("DOGE") != std::string::npos)
-            return 0.15;
-        else if (product.find("BTC") != std::string::npos)
-            return 50000.0;
-        else if (product.find("ETH") != std::string::npos)
-            return 3000.0;
-        return 100.0;
-    }
-
-    // Calculate average historical price
-    double sum = 0.0;
-    for (const OrderBookEntry& entry : allOrders)
-    {
-        sum += entry.price;
-    }
-    double avgPrice = sum / allOrders.size();
-
-    // Apply 5-year growth factor (15% annual = 2.011x total)
-    double growthFactor = 1.15 * 1.15 * 1.15 * 1.15 * 1.15;
-    double adjustedPrice = avgPrice * growthFactor;
-
-    // Add random variation (±5%)
-    double variation = 0.95 + (std::rand() % 100) / 1000.0;
-
-    return adjustedPrice * variation;
-}
-
-double MerkelMain::calculateBidPrice(std::string product)
-{
-    // TASK 4: Bid price is typically 1-3% lower than ask (market spread)
-    double askPrice = calculateAskPrice(product);
-    double spreadFactor = 0.97 + (std::rand() % 30) / 1000.0;
-    return askPrice * spreadFactor;
-}
-
-void MerkelMain::placeAsk()
-{
-    std::cout << "\n========== PLACE ASK (SELL ORDER) ==========" << std::endl;
-
-    std::string product = getValidatedProductInput();
-    double price = getValidatedDoubleInput("Enter price: ");
-    double amount = getValidatedDoubleInput("Enter amount: ");
-
-    if (price <= 0 || amount <= 0)
-    {
-        std::cout << "Price and amount must be positive." << std::endl;
-        return;
-    }
-
-    std::string timestamp = getCurrentTimestamp();
-    OrderBookEntry obe(price, amount, timestamp, product,
-        OrderBookType::ask, currentUser.getUsername());
-
-    if (wallet.canFulfilOrder(obe))
-    {
-        orderBook.insertOrder(obe);
-
-        Transaction trans(currentUser.getUsername(), timestamp, TransactionType::ASK_PLACED,
-            product, amount, price, 0.0);
-        dataManager.saveTransaction(trans);
-
-        std::cout << "\nAsk order placed successfully!" << std::endl;
-    }
-    else
-    {
-        std::cout << "\nInsufficient funds in wallet." << std::endl;
-    }
-}
-
-void MerkelMain::placeBid()
-{
-    std::cout << "\n========== PLACE BID (BUY ORDER) ==========" << std::endl;
-
-    std::string product = getValidatedProductInput();
-    double price = getValidatedDoubleInput("Enter price: ");
-    double amount = getValidatedDoubleInput("Enter amount: ");
-
-    if (price <= 0 || amount <= 0)
-    {
-        std::cout << "Price and amount must be positive." << std::endl;
-        return;
-    }
-
-    std::string timestamp = getCurrentTimestamp();
-    OrderBookEntry obe(price, amount, timestamp, product,
-        OrderBookType::bid, currentUser.getUsername());
-
-    if (wallet.canFulfilOrder(obe))
-    {
-        orderBook.insertOrder(obe);
-
-        Transaction trans(currentUser.getUsername(), timestamp, TransactionType::BID_PLACED,
-            product, amount, price, 0.0);
-        dataManager.saveTransaction(trans);
-
-        std::cout << "\nBid order placed successfully!" << std::endl;
-    }
-    else
-    {
-        std::cout << "\nInsufficient funds in wallet." << std::endl;
-    }
-}
-
-// ==================== TASK 5: INPUT VALIDATION ====================
-
-std::string MerkelMain::getValidatedStringInput(std::string prompt)
-{
-    std::string input;
-    while (true)
-    {
-        std::cout << prompt;
-        std::getline(std::cin, input);
-
-        // Remove leading/trailing whitespace
-        input.erase(0, input.find_first_not_of(" \t\n\r"));
-        input.erase(input.find_last_not_of(" \t\n\r") + 1);
-
-        if (!input.empty())
-        {
-            return input;
-        }
-        std::cout << "Input cannot be empty. Please try again." << std::endl;
-    }
-}
-
-double MerkelMain::getValidatedDoubleInput(std::string prompt)
-{
-    std::string input;
-    double value;
-
-    while (true)
-    {
-        std::cout << prompt;
-        std::getline(std::cin, input);
-
-        if (input.empty())
-        {
-            std::cout << "Input cannot be empty. Please try again." << std::endl;
-            continue;
-        }
-
-        try
-        {
-            value = std::stod(input);
-
-            // Check for NaN and infinity
-            if (std::isnan(value) || std::isinf(value))
-            {
-                std::cout << "Invalid number. Please enter a valid decimal number." << std::endl;
-                continue;
-            }
-
-            return value;
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "Invalid number. Please enter a valid decimal number." << std::endl;
-        }
-    }
-}
-
-int MerkelMain::getValidatedIntInput(std::string prompt, int min, int max)
-{
-    std::string input;
-    int value;
-
-    while (true)
-    {
-        std::cout << prompt;
-        std::getline(std::cin, input);
-
-        try
-        {
-            value = std::stoi(input);
-
-            if (value >= min && value <= max)
-            {
-                return value;
-            }
-            std::cout << "Please enter a number between " << min << " and " << max << ": ";
-        }
-        catch (const std::exception& e)
-        {
-            std::cout << "Invalid input. Please enter a number between " << min << " and " << max << ": ";
-        }
-    }
-}
-
-std::string MerkelMain::getValidatedProductInput()
-{
-    std::vector<std::string> knownProducts = orderBook.getKnownProducts();
-
-    std::cout << "\nAvailable products:" << std::endl;
-    for (size_t i = 0; i < knownProducts.size(); i++)
-    {
-        std::cout << (i + 1) << ": " << knownProducts[i] << std::endl;
-    }
-
-    int choice = getValidatedIntInput("Enter product number: ", 1, knownProducts.size());
-    return knownProducts[choice - 1];
-}
-
-std::string MerkelMain::getValidatedCurrencyInput(std::string prompt)
-{
-    std::vector<std::string> validCurrencies = getKnownCurrencies();
-    std::string currency;
-
-    while (true)
-    {
-        std::cout << prompt;
-        std::cout << "\nAvailable currencies: ";
-        for (size_t i = 0; i < validCurrencies.size(); i++)
-        {
-            std::cout << validCurrencies[i];
-            if (i < validCurrencies.size() - 1) std::cout << ", ";
-        }
-        std::cout << "\nEnter currency: ";
-
-        std::getline(std::cin, currency);
-
-        // Remove whitespace
-        currency.erase(0, currency.find_first_not_of(" \t\n\r"));
-        currency.erase(currency.find_last_not_of(" \t\n\r") + 1);
-
-        if (currency.empty())
-        {
-            std::cout << "Currency cannot be empty. Please try again.\n" << std::endl;
-            continue;
-        }
-
-        // Convert to uppercase for validation
-        std::transform(currency.begin(), currency.end(), currency.begin(), ::toupper);
-
-        if (isValidCurrency(currency))
-        {
-            return currency;
-        }
-
-        std::cout << "Invalid currency. Please enter one of the available currencies.\n" << std::endl;
-    }
-}
-
-bool MerkelMain::validateEmail(std::string email)
-{
-    const std::regex pattern("^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$");
-    return std::regex_match(email, pattern);
-}
-
-bool MerkelMain::isValidCurrency(std::string currency)
-{
-    std::vector<std::string> validCurrencies = getKnownCurrencies();
-
-    // Convert to uppercase for comparison
-    std::transform(currency.begin(), currency.end(), currency.begin(), ::toupper);
-
-    for (const std::string& valid : validCurrencies)
-    {
-        if (currency == valid)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-std::vector<std::string> MerkelMain::getKnownCurrencies()
-{
-    // Extract unique currencies from all product pairs
-    std::vector<std::string> currencies;
-    std::vector<std::string> products = orderBook.getKnownProducts();
-
-    for (const std::string& product : products)
-    {
-        size_t slashPos = product.find('/');
-        if (slashPos != std::string::npos)
-        {
-            std::string currency1 = product.substr(0, slashPos);
-            std::string currency2 = product.substr(slashPos + 1);
-
-            // Add unique currencies
-            if (std::find(currencies.begin(), currencies.end(), currency1) == currencies.end())
-            {
-                currencies.push_back(currency1);
-            }
-            if (std::find(currencies.begin(), currencies.end(), currency2) == currencies.end())
-            {
-                currencies.push_back(currency2);
-            }
-        }
-    }
-
-    return currencies;
-}
-
-// ==================== HELPER FUNCTIONS ====================
-
-void MerkelMain::printMarketStats()
-{
-    std::cout << "\n========== MARKET STATISTICS ==========" << std::endl;
-
-    for (const std::string& product : orderBook.getKnownProducts())
-    {
-        std::cout << "\n--- " << product << " ---" << std::endl;
-
-        std::vector<OrderBookEntry> asks = orderBook.getOrders(OrderBookType::ask,
-            product, currentTime);
-        std::vector<OrderBookEntry> bids = orderBook.getOrders(OrderBookType::bid,
-            product, currentTime);
-
-        std::cout << "Asks available: " << asks.size() << std::endl;
-        if (!asks.empty())
-        {
-            std::cout << std::fixed << std::setprecision(8);
-            std::cout << "  Max ask: " << OrderBook::getHighPrice(asks) << std::endl;
-            std::cout << "  Min ask: " << OrderBook::getLowPrice(asks) << std::endl;
-        }
-
-        std::cout << "Bids available: " << bids.size() << std::endl;
-        if (!bids.empty())
-        {
-            std::cout << std::fixed << std::setprecision(8);
-            std::cout << "  Max bid: " << OrderBook::getHighPrice(bids) << std::endl;
-            std::cout << "  Min bid: " << OrderBook::getLowPrice(bids) << std::endl;
-        }
-    }
-}
-
-void MerkelMain::gotoNextTimeframe()
-{
-    std::cout << "\nAdvancing to next timeframe..." << std::endl;
-
-    for (std::string& product : orderBook.getKnownProducts())
-    {
-        std::cout << "Matching " << product << "..." << std::endl;
-        std::vector<OrderBookEntry> sales = orderBook.matchAsksToBids(product, currentTime);
-
-        std::cout << "Sales: " << sales.size() << std::endl;
-
-        for (OrderBookEntry& sale : sales)
-        {
-            if (sale.username == currentUser.getUsername())
-            {
-                wallet.processSale(sale);
-
-                TransactionType type = (sale.orderType == OrderBookType::asksale) ?
-                    TransactionType::ASK_FILLED : TransactionType::BID_FILLED;
-
-                Transaction trans(currentUser.getUsername(), sale.timestamp, type,
-                    sale.product, sale.amount, sale.price, 0.0);
-                dataManager.saveTransaction(trans);
-            }
-        }
-    }
-
-    currentTime = orderBook.getNextTime(currentTime);
-    saveCurrentWalletState();
-
-    std::cout << "New timeframe: " << currentTime << std::endl;
-}
-
-void MerkelMain::saveCurrentWalletState()
-{
-    std::string walletStr = wallet.toString();
-    std::istringstream iss(walletStr);
-    std::string line;
-
-    while (std::getline(iss, line))
-    {
-        if (line.empty()) continue;
-
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos)
-        {
-            std::string currency = line.substr(0, colonPos);
-            std::string amountStr = line.substr(colonPos + 2);
-
-            // Remove whitespace
-            currency.erase(std::remove_if(currency.begin(), currency.end(), ::isspace), currency.end());
-            amountStr.erase(std::remove_if(amountStr.begin(), amountStr.end(), ::isspace), amountStr.end());
-
-            try
-            {
-                double amount = std::stod(amountStr);
-                dataManager.saveWalletBalance(currentUser.getUsername(), currency, amount);
-            }
-            catch (const std::exception& e)
-            {
-                // Skip invalid entries
-            }
-        }
-    }
-}
-
-void MerkelMain::loadUserWallet()
-{
-    std::map<std::string, double> walletData = dataManager.loadWalletBalance(currentUser.getUsername());
-
-    for (const auto& pair : walletData)
-    {
-        wallet.insertCurrency(pair.first, pair.second);
-    }
-
-    // Initialize with default values if wallet is empty
-    if (walletData.empty())
-    {
-        wallet.insertCurrency("USDT", 10000.0);
-        wallet.insertCurrency("BTC", 0.5);
-        wallet.insertCurrency("ETH", 5.0);
-        saveCurrentWalletState();
-    }
-}
-
-std::string MerkelMain::getCurrentTimestamp()
-{
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-
-#pragma warning(suppress : 4996)
-    std::tm* now_tm = std::localtime(&now_c);
-
-    char buffer[100];
-    std::strftime(buffer, sizeof(buffer), "%Y/%m/%d %H:%M:%S", now_tm);
-
-    return std::string(buffer);
+﻿// ==================== MerkelMain.cpp ====================
+/**
+ * MerkelMain.cpp
+ * Implementation of main application controller
+ * Handles all user interactions, trading operations, and data management
+ */
+
+#include "MerkelMain.h"
+#include "CSVReader.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <chrono>
+#include <ctime>
+#include <regex>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+MerkelMain::MerkelMain()
+    : orderBook("20200317.csv"), isAuthenticated(false), quiet(false)
+{
+    currentTime = orderBook.getEarliestTime();
+    replayedUntil = currentTime;
+    referencePrices.build(orderBook.getAllOrders());
+}
+
+void MerkelMain::init()
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "  CRYPTOCURRENCY TRADING SIMULATOR" << std::endl;
+    std::cout << "  Technical Analysis Toolkit" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    // Force login/register before accessing main features
+    while (!isLoggedIn())
+    {
+        loginOrRegister();
+    }
+
+    // Load user's wallet after successful login
+    loadUserWallet();
+
+    // Main application loop
+    int input;
+    while (true)
+    {
+        printMainMenu();
+        input = getUserOption();
+        processUserOption(input);
+    }
+}
+
+// ==================== MENU FUNCTIONS ====================
+
+void MerkelMain::printMainMenu()
+{
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  MAIN MENU - Welcome " << currentUser.getFullName() << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "1: View Candlestick Data (Technical Analysis)" << std::endl;
+    std::cout << "2: Manage Wallet & View Balance" << std::endl;
+    std::cout << "3: View Transaction History" << std::endl;
+    std::cout << "4: View Trading Statistics" << std::endl;
+    std::cout << "5: Place Ask (Sell Order)" << std::endl;
+    std::cout << "6: Place Bid (Buy Order)" << std::endl;
+    std::cout << "7: Simulate Trading Activity" << std::endl;
+    std::cout << "8: View Market Statistics" << std::endl;
+    std::cout << "9: Help" << std::endl;
+    std::cout << "10: Logout" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Current Time: " << currentTime << std::endl;
+    std::cout << "========================================" << std::endl;
+}
+
+void MerkelMain::printHelpMenu()
+{
+    std::cout << "\n========== HELP MENU ==========" << std::endl;
+    std::cout << "This is a cryptocurrency trading simulator with technical analysis tools." << std::endl;
+    std::cout << "\nFeatures:" << std::endl;
+    std::cout << "- Candlestick Analysis: View OHLC data for any product and timeframe" << std::endl;
+    std::cout << "- Wallet Management: Deposit, withdraw, and track your funds" << std::endl;
+    std::cout << "- Trading: Place ask (sell) and bid (buy) orders" << std::endl;
+    std::cout << "- History: View all your past transactions and statistics" << std::endl;
+    std::cout << "\nGoal: Analyze market trends and make profitable trades!" << std::endl;
+    std::cout << "================================" << std::endl;
+}
+
+int MerkelMain::getUserOption()
+{
+    int userOption = 0;
+    std::string line;
+    std::cout << "\nEnter your choice (1-10): ";
+
+    while (true)
+    {
+        std::getline(std::cin, line);
+
+        if (line.empty())
+        {
+            std::cout << "Input cannot be empty. Please enter a number (1-10): ";
+            continue;
+        }
+
+        // Check if input is numeric
+        bool isNumeric = true;
+        for (char c : line)
+        {
+            if (!isdigit(c))
+            {
+                isNumeric = false;
+                break;
+            }
+        }
+
+        if (!isNumeric)
+        {
+            std::cout << "Invalid input. Please enter a valid number (1-10): ";
+            continue;
+        }
+
+        try
+        {
+            userOption = std::stoi(line);
+
+            if (userOption < 1 || userOption > 10)
+            {
+                std::cout << "Invalid choice. Please enter a number between 1-10: ";
+                continue;
+            }
+
+            break;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Invalid input. Please enter a number (1-10): ";
+        }
+    }
+
+    return userOption;
+}
+
+void MerkelMain::processUserOption(int userOption)
+{
+    switch (userOption)
+    {
+    case 1:
+        displayCandlestickData();
+        break;
+    case 2:
+        manageWallet();
+        break;
+    case 3:
+        viewTransactionHistory();
+        break;
+    case 4:
+        viewUserStatistics();
+        break;
+    case 5:
+        placeAsk();
+        break;
+    case 6:
+        placeBid();
+        break;
+    case 7:
+        simulateTrading();
+        break;
+    case 8:
+        printMarketStats();
+        break;
+    case 9:
+        printHelpMenu();
+        break;
+    case 10:
+        std::cout << "\nLogging out... Goodbye!" << std::endl;
+        dataManager.flush();
+        currentUser = User();
+        isAuthenticated = false;
+        exit(0);
+        break;
+    default:
+        std::cout << "Invalid option." << std::endl;
+    }
+}
+
+// ==================== TASK 1: CANDLESTICK DATA ====================
+
+void MerkelMain::displayCandlestickData()
+{
+    std::cout << "\n========== CANDLESTICK TECHNICAL ANALYSIS ==========" << std::endl;
+
+    std::string product = getValidatedProductInput();
+
+    CandleInterval interval = getValidatedIntervalInput();
+
+    showCandlestickData(product, interval);
+}
+
+void MerkelMain::showCandlestickData(const std::string& product, const CandleInterval& interval)
+{
+    std::cout << "\nGenerating candlestick data for " << product << " (" << interval.toString() << ")..." << std::endl;
+
+    // Live candles cover everything replayed so far plus orders placed since
+    CandleSeries askCandlesticks = getLiveCandles(product, interval, OrderBookType::ask);
+    CandleSeries bidCandlesticks = getLiveCandles(product, interval, OrderBookType::bid);
+
+    // Display results
+    std::cout << "\n========== ASK (SELL) ORDERS ==========" << std::endl;
+    printCandlestickTable(askCandlesticks, "ASK");
+
+    std::cout << "\n========== BID (BUY) ORDERS ==========" << std::endl;
+    printCandlestickTable(bidCandlesticks, "BID");
+
+    std::cout << "\n========== TECHNICAL INDICATORS (LATEST CANDLE) ==========" << std::endl;
+    if (!askCandlesticks.empty())
+    {
+        printIndicatorSummary(getLiveIndicators(product, interval, OrderBookType::ask), "ASK");
+    }
+    if (!bidCandlesticks.empty())
+    {
+        printIndicatorSummary(getLiveIndicators(product, interval, OrderBookType::bid), "BID");
+    }
+}
+
+void MerkelMain::printCandlestickTable(const CandleSeries& candlesticks, std::string type)
+{
+    if (candlesticks.empty())
+    {
+        std::cout << "No data available for this product." << std::endl;
+        return;
+    }
+
+    // Print table header
+    std::cout << std::left << std::setw(20) << "Date"
+        << std::right << std::setw(12) << "Open"
+        << std::setw(12) << "High"
+        << std::setw(12) << "Low"
+        << std::setw(12) << "Close"
+        << std::setw(16) << "Volume"
+        << std::setw(8) << "Trades"
+        << std::setw(12) << "VWAP" << std::endl;
+    std::cout << std::string(104, '-') << std::endl;
+
+    // Print each candlestick
+    std::cout << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < candlesticks.size(); i++)
+    {
+        std::cout << std::left << std::setw(20) << candlesticks.getDate(i)
+            << std::right << std::setw(12) << candlesticks.getOpen(i)
+            << std::setw(12) << candlesticks.getHigh(i)
+            << std::setw(12) << candlesticks.getLow(i)
+            << std::setw(12) << candlesticks.getClose(i)
+            << std::setw(16) << candlesticks.getVolume(i)
+            << std::setw(8) << candlesticks.getTrades(i)
+            << std::setw(12) << candlesticks.getVWAP(i) << std::endl;
+    }
+
+    std::cout << "\nTotal records: " << candlesticks.size() << std::endl;
+}
+
+void MerkelMain::printIndicatorSummary(const IndicatorEngine& indicators, std::string type)
+{
+    const std::vector<std::string>& names = indicators.getNames();
+    std::vector<double> values = indicators.getValues();
+
+    std::cout << "\n" << type << ":" << std::endl;
+    std::cout << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        double value = values[i];
+        std::cout << "  " << std::left << std::setw(26) << names[i] << std::right;
+        if (std::isnan(value))
+        {
+            std::cout << "n/a (needs more candles)" << std::endl;
+        }
+        else
+        {
+            std::cout << value << std::endl;
+        }
+    }
+}
+
+CandleInterval MerkelMain::getValidatedIntervalInput()
+{
+    std::cout << "\nSelect candle interval:" << std::endl;
+    std::cout << "1: 1 second" << std::endl;
+    std::cout << "2: 1 minute" << std::endl;
+    std::cout << "3: 5 minutes" << std::endl;
+    std::cout << "4: 1 hour" << std::endl;
+    std::cout << "5: Daily" << std::endl;
+    std::cout << "6: Monthly" << std::endl;
+    std::cout << "7: Yearly (default)" << std::endl;
+    std::cout << "8: Custom (e.g. 10s, 15m, 4h, 1w)" << std::endl;
+    int choice = getValidatedIntInput("Enter choice (1-8): ", 1, 8);
+
+    const char* presets[] = { "1s", "1m", "5m", "1h", "1d", "1M", "1y" };
+    CandleInterval interval;
+    if (choice < 8)
+    {
+        CandleInterval::parse(presets[choice - 1], interval);
+        return interval;
+    }
+
+    while (true)
+    {
+        std::string text = getValidatedStringInput("Enter interval: ");
+        if (!CandleInterval::parse(text, interval))
+        {
+            std::cout << "Invalid interval. Use a number followed by s, m, h, d, w, M or y." << std::endl;
+        }
+        else if (!CandlestickPyramid::supports(interval))
+        {
+            std::cout << "Live candles need a whole number of seconds." << std::endl;
+        }
+        else
+        {
+            return interval;
+        }
+    }
+}
+
+CandleSeries MerkelMain::getLiveCandles(const std::string& product,
+    const CandleInterval& interval, OrderBookType type)
+{
+    return candleCache.getSeries(product, interval, type, [this](CandlestickPyramid& pyramid)
+    {
+        loadLiveCandles(pyramid);
+    });
+}
+
+IndicatorEngine MerkelMain::getLiveIndicators(const std::string& product,
+    const CandleInterval& interval, OrderBookType type)
+{
+    return candleCache.getIndicators(product, interval, type, [this](CandlestickPyramid& pyramid)
+    {
+        loadLiveCandles(pyramid);
+    });
+}
+
+void MerkelMain::loadLiveCandles(CandlestickPyramid& pyramid)
+{
+    // First request for a product and side: one pass over the replay so far
+    for (const OrderBookEntry& order : orderBook.getAllOrders())
+    {
+        if (order.timestamp <= replayedUntil || order.username != "dataset")
+        {
+            pyramid.addOrder(order);
+        }
+    }
+}
+
+void MerkelMain::feedLiveCandles(const OrderBookEntry& order)
+{
+    candleCache.addOrder(order);
+}
+
+void MerkelMain::advanceLiveCandles()
+{
+    // When the replay wraps around, its timeframes are already in the candles
+    if (currentTime <= replayedUntil)
+    {
+        return;
+    }
+    replayedUntil = currentTime;
+
+    // Orders are sorted by timestamp, so the new timeframe is one contiguous range
+    const std::vector<OrderBookEntry>& orders = orderBook.getAllOrders();
+    auto first = std::lower_bound(orders.begin(), orders.end(), currentTime,
+        [](const OrderBookEntry& order, const std::string& time) { return order.timestamp < time; });
+
+    for (auto it = first; it != orders.end() && it->timestamp == currentTime; ++it)
+    {
+        if (it->username == "dataset")
+        {
+            feedLiveCandles(*it);
+        }
+    }
+}
+
+// ==================== TASK 2: USER AUTHENTICATION ====================
+
+void MerkelMain::loginOrRegister()
+{
+    std::cout << "\n========== AUTHENTICATION ==========" << std::endl;
+    std::cout << "1: Login" << std::endl;
+    std::cout << "2: Register" << std::endl;
+    std::cout << "3: Forgot Password" << std::endl;
+
+    int choice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
+
+    if (choice == 1)
+    {
+        loginUser();
+    }
+    else if (choice == 2)
+    {
+        registerNewUser();
+    }
+    else if (choice == 3)
+    {
+        forgotPassword();
+    }
+}
+
+void MerkelMain::registerNewUser()
+{
+    std::cout << "\n========== USER REGISTRATION ==========" << std::endl;
+
+    std::string fullName = getValidatedStringInput("Enter full name: ");
+
+    // Email validation loop
+    std::string email;
+    while (true)
+    {
+        email = getValidatedStringInput("Enter email address: ");
+        if (validateEmail(email))
+        {
+            break;
+        }
+        std::cout << "Invalid email format. Please try again." << std::endl;
+    }
+
+    // Check for duplicate users
+    if (dataManager.userExists(email, fullName))
+    {
+        std::cout << "\nUser with this email and name already exists!" << std::endl;
+        std::cout << "Please login instead or use a different email." << std::endl;
+        return;
+    }
+
+    std::string password = getValidatedStringInput("Enter password: ");
+    std::string confirmPassword = getValidatedStringInput("Confirm password: ");
+
+    if (password != confirmPassword)
+    {
+        std::cout << "Passwords do not match. Registration failed." << std::endl;
+        return;
+    }
+
+    createUser(fullName, email, password);
+}
+
+bool MerkelMain::createUser(const std::string& fullName, const std::string& email, const std::string& password)
+{
+    // Generate unique username and hash password
+    std::string username = User::generateUsername();
+    std::string passwordHash = User::hashPassword(password);
+
+    // Create and save user
+    User newUser(username, fullName, email, passwordHash);
+    if (dataManager.saveUser(newUser))
+    {
+        std::cout << "\n========== REGISTRATION SUCCESSFUL ==========" << std::endl;
+        std::cout << "Your username is: " << username << std::endl;
+        std::cout << "Please save this for future logins!" << std::endl;
+        std::cout << "=============================================" << std::endl;
+
+        // Auto-login; a username just generated is not in use elsewhere
+        dataManager.claimUser(username);
+        currentUser = newUser;
+        isAuthenticated = true;
+        sessionUsers.insert(username);
+
+        // Initialize wallet with starting balance
+        ledger.deposit(currentUser.getUsername(), "USDT", 10000.0);
+        ledger.deposit(currentUser.getUsername(), "BTC", 0.5);
+        ledger.deposit(currentUser.getUsername(), "ETH", 5.0);
+        saveCurrentWalletState();
+        return true;
+    }
+
+    std::cout << "Registration failed. Please try again." << std::endl;
+    return false;
+}
+
+void MerkelMain::loginUser()
+{
+    std::cout << "\n========== USER LOGIN ==========" << std::endl;
+
+    std::string username = getValidatedStringInput("Enter username (10 digits): ");
+    std::string password = getValidatedStringInput("Enter password: ");
+
+    authenticate(username, password);
+}
+
+bool MerkelMain::authenticate(const std::string& username, const std::string& password)
+{
+    // Load user from database
+    User user = dataManager.loadUser(username);
+
+    if (user.getUsername().empty())
+    {
+        std::cout << "User not found. Please check your username or register." << std::endl;
+        return false;
+    }
+
+    // Verify password by comparing hashes
+    std::string passwordHash = User::hashPassword(password);
+    if (passwordHash == user.getPasswordHash())
+    {
+        if (!dataManager.claimUser(username))
+        {
+            std::cout << "This account is logged in from another process. Login failed." << std::endl;
+            return false;
+        }
+
+        std::cout << "\n========== LOGIN SUCCESSFUL ==========" << std::endl;
+        std::cout << "Welcome back, " << user.getFullName() << "!" << std::endl;
+        std::cout << "======================================" << std::endl;
+        currentUser = user;
+        isAuthenticated = true;
+        sessionUsers.insert(username);
+        return true;
+    }
+
+    std::cout << "Incorrect password. Login failed." << std::endl;
+    return false;
+}
+
+void MerkelMain::forgotPassword()
+{
+    std::cout << "\n========== PASSWORD RECOVERY ==========" << std::endl;
+
+    std::string email = getValidatedStringInput("Enter your registered email: ");
+
+    User user = dataManager.getUserByEmail(email);
+
+    if (user.getUsername().empty())
+    {
+        std::cout << "No account found with this email." << std::endl;
+        return;
+    }
+
+    std::cout << "\nAccount found!" << std::endl;
+    std::cout << "Username: " << user.getUsername() << std::endl;
+    std::cout << "Full Name: " << user.getFullName() << std::endl;
+
+    std::cout << "\nWould you like to reset your password? (yes/no): ";
+    std::string response;
+    std::getline(std::cin, response);
+
+    if (response == "yes" || response == "y" || response == "Yes")
+    {
+        std::string newPassword = getValidatedStringInput("Enter new password: ");
+        std::string confirmPassword = getValidatedStringInput("Confirm new password: ");
+
+        if (newPassword != confirmPassword)
+        {
+            std::cout << "Passwords do not match. Reset failed." << std::endl;
+            return;
+        }
+
+        std::cout << "\nPassword reset successful! Please login with your new password." << std::endl;
+    }
+}
+
+// ==================== TASK 3: WALLET & TRANSACTION HISTORY ====================
+
+void MerkelMain::manageWallet()
+{
+    std::cout << "\n========== WALLET MANAGEMENT ==========" << std::endl;
+    std::cout << "1: View Balance" << std::endl;
+    std::cout << "2: Deposit Funds" << std::endl;
+    std::cout << "3: Withdraw Funds" << std::endl;
+
+    int choice = getValidatedIntInput("Enter choice (1-3): ", 1, 3);
+
+    if (choice == 1)
+    {
+        viewWalletBalance();
+    }
+    else if (choice == 2)
+    {
+        depositFunds();
+    }
+    else if (choice == 3)
+    {
+        withdrawFunds();
+    }
+}
+
+void MerkelMain::depositFunds()
+{
+    std::cout << "\n========== DEPOSIT FUNDS ==========" << std::endl;
+
+    // TASK 5: Currency validation
+    std::string currency = getValidatedCurrencyInput("Select a currency to deposit");
+
+    // TASK 5: Amount validation with limits
+    double amount = 0.0;
+    while (true)
+    {
+        amount = getValidatedDoubleInput("Enter amount to deposit: ");
+
+        if (amount <= 0)
+        {
+            std::cout << "Amount must be positive. Please try again." << std::endl;
+            continue;
+        }
+
+        if (amount > 1000000000.0)
+        {
+            std::cout << "Amount too large. Maximum deposit is 1,000,000,000. Please try again." << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    double newBalance = deposit(currency, amount);
+
+    std::cout << "\nDeposit successful!" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "New " << currency << " balance: " << newBalance << std::endl;
+}
+
+double MerkelMain::deposit(const std::string& currency, double amount)
+{
+    // Get current balance
+    double currentBalance = ledger.getBalance(currentUser.getUsername(), currency);
+
+    ledger.deposit(currentUser.getUsername(), currency, amount);
+    saveCurrentWalletState();
+
+    // Log transaction
+    std::string timestamp = getCurrentTimestamp();
+    double newBalance = currentBalance + amount;
+    Transaction trans(currentUser.getUsername(), timestamp, TransactionType::DEPOSIT,
+        currency, amount, 0.0, newBalance);
+    dataManager.saveTransaction(trans);
+
+    return newBalance;
+}
+
+void MerkelMain::withdrawFunds()
+{
+    std::cout << "\n========== WITHDRAW FUNDS ==========" << std::endl;
+
+    // TASK 5: Currency validation
+    std::string currency = getValidatedCurrencyInput("Select a currency to withdraw");
+
+    if (!ledger.containsCurrency(currentUser.getUsername(), currency, 0))
+    {
+        std::cout << "You don't have any " << currency << " in your wallet." << std::endl;
+        return;
+    }
+
+    // TASK 5: Amount validation with limits
+    double amount = 0.0;
+    while (true)
+    {
+        amount = getValidatedDoubleInput("Enter amount to withdraw: ");
+
+        if (amount <= 0)
+        {
+            std::cout << "Amount must be positive. Please try again." << std::endl;
+            continue;
+        }
+
+        if (amount > 1000000000.0)
+        {
+            std::cout << "Amount too large. Maximum withdrawal is 1,000,000,000. Please try again." << std::endl;
+            continue;
+        }
+
+        break;
+    }
+
+    if (!ledger.containsCurrency(currentUser.getUsername(), currency, amount))
+    {
+        std::cout << "Insufficient funds in wallet." << std::endl;
+        std::cout << "You attempted to withdraw " << amount << " " << currency << std::endl;
+        return;
+    }
+
+    if (withdraw(currency, amount))
+    {
+        std::cout << "\nWithdrawal successful!" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Withdrew " << amount << " " << currency << std::endl;
+    }
+    else
+    {
+        std::cout << "Withdrawal failed." << std::endl;
+    }
+}
+
+bool MerkelMain::withdraw(const std::string& currency, double amount)
+{
+    if (!ledger.withdraw(currentUser.getUsername(), currency, amount))
+    {
+        return false;
+    }
+
+    saveCurrentWalletState();
+
+    // Log transaction
+    std::string timestamp = getCurrentTimestamp();
+    Transaction trans(currentUser.getUsername(), timestamp, TransactionType::WITHDRAWAL,
+        currency, amount, 0.0, 0.0);
+    dataManager.saveTransaction(trans);
+    return true;
+}
+
+void MerkelMain::viewWalletBalance()
+{
+    std::cout << "\n========== WALLET BALANCE ==========" << std::endl;
+    std::cout << ledger.getWallet(currentUser.getUsername()).toString();
+    std::cout << "====================================" << std::endl;
+}
+
+void MerkelMain::viewTransactionHistory()
+{
+    std::cout << "\n========== TRANSACTION HISTORY ==========" << std::endl;
+    std::cout << "1: View all transactions" << std::endl;
+    std::cout << "2: View last 5 transactions" << std::endl;
+    std::cout << "3: View by product" << std::endl;
+    std::cout << "4: View by date range" << std::endl;
+
+    int choice = getValidatedIntInput("Enter choice (1-4): ", 1, 4);
+
+    std::vector<Transaction> transactions;
+
+    if (choice == 1)
+    {
+        transactions = dataManager.loadUserTransactions(currentUser.getUsername());
+    }
+    else if (choice == 2)
+    {
+        transactions = dataManager.loadUserTransactions(currentUser.getUsername(), 5);
+    }
+    else if (choice == 3)
+    {
+        std::string product = getValidatedStringInput("Enter product (e.g., ETH/USDT): ");
+        transactions = dataManager.loadUserTransactionsByProduct(currentUser.getUsername(), product);
+    }
+    else if (choice == 4)
+    {
+        std::string from = getValidatedStringInput("Enter start date (YYYY/MM/DD): ");
+        std::string to = getValidatedStringInput("Enter end date (YYYY/MM/DD): ");
+        transactions = dataManager.queryTransactions(from, to, currentUser.getUsername());
+    }
+
+    if (transactions.empty())
+    {
+        std::cout << "No transactions found." << std::endl;
+        return;
+    }
+
+    std::cout << "\nTransaction History:" << std::endl;
+    std::cout << std::string(80, '-') << std::endl;
+    for (const Transaction& trans : transactions)
+    {
+        std::cout << trans.toString() << std::endl;
+    }
+    std::cout << "\nTotal transactions: " << transactions.size() << std::endl;
+}
+
+void MerkelMain::viewUserStatistics()
+{
+    std::cout << "\n========== USER TRADING STATISTICS ==========" << std::endl;
+
+    std::vector<Transaction> allTransactions = dataManager.loadUserTransactions(currentUser.getUsername());
+
+    if (allTransactions.empty())
+    {
+        std::cout << "No trading activity yet." << std::endl;
+        return;
+    }
+
+    // Calculate statistics
+    int totalAsks = 0, totalBids = 0;
+    double totalMoneySpent = 0.0;
+    std::map<std::string, int> productAsks, productBids;
+
+    for (const Transaction& trans : allTransactions)
+    {
+        TransactionType type = trans.getType();
+        std::string product = trans.getProduct();
+
+        if (type == TransactionType::ASK_PLACED || type == TransactionType::ASK_FILLED)
+        {
+            totalAsks++;
+            productAsks[product]++;
+        }
+        else if (type == TransactionType::BID_PLACED || type == TransactionType::BID_FILLED)
+        {
+            totalBids++;
+            productBids[product]++;
+            totalMoneySpent += trans.getAmount() * trans.getPrice();
+        }
+    }
+
+    std::cout << "Total Transactions: " << allTransactions.size() << std::endl;
+    std::cout << "Total Asks (Sell Orders): " << totalAsks << std::endl;
+    std::cout << "Total Bids (Buy Orders): " << totalBids << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Total Money Spent: " << totalMoneySpent << std::endl;
+
+    std::cout << "\n--- Asks by Product ---" << std::endl;
+    for (const auto& pair : productAsks)
+    {
+        std::cout << pair.first << ": " << pair.second << " asks" << std::endl;
+    }
+
+    std::cout << "\n--- Bids by Product ---" << std::endl;
+    for (const auto& pair : productBids)
+    {
+        std::cout << pair.first << ": " << pair.second << " bids" << std::endl;
+    }
+}
+
+// ==================== TASK 4: TRADING SIMULATION ====================
+
+void MerkelMain::simulateTrading()
+{
+    std::cout << "\n========== SIMULATE TRADING ACTIVITY ==========" << std::endl;
+    std::cout << "Runs simulated market makers, takers and random walkers against the" << std::endl;
+    std::cout << "order book, advancing the replay one timeframe per round." << std::endl;
+    std::cout << "Agent accounts are refunded for every run; the replay carries on from" << std::endl;
+    std::cout << "the current timeframe." << std::endl;
+
+    AgentSimulation::Config config;
+    config.marketMakers = getValidatedIntInput("Market makers (0-100000): ", 0, 100000);
+    config.takers = getValidatedIntInput("Takers (0-100000): ", 0, 100000);
+    config.randomWalkers = getValidatedIntInput("Random walkers (0-100000): ", 0, 100000);
+    config.timeframes = getValidatedIntInput("Timeframes (1-10000): ", 1, 10000);
+    config.seed = getValidatedIntInput("Random seed (0-1000000): ", 0, 1000000);
+
+    bool wasQuiet = quiet;
+    quiet = true;
+    runAgentSimulation(config);
+    quiet = wasQuiet;
+}
+
+void MerkelMain::runAgentSimulation(const AgentSimulation::Config& config)
+{
+    typedef std::chrono::steady_clock Clock;
+    auto millisSince = [](Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    AgentSimulation simulation(config, orderBook.getKnownProducts());
+    simulation.fund(ledger, referencePrices.getMids());
+
+    size_t orders = 0, rejected = 0, trades = 0;
+    double generateMillis = 0.0, insertMillis = 0.0, matchMillis = 0.0;
+    Clock::time_point runStart = Clock::now();
+
+    for (int round = 0; round < config.timeframes; round++)
+    {
+        // Agents quote around each product's rolling mid
+        Clock::time_point start = Clock::now();
+        std::vector<OrderBookEntry> batch = simulation.generate(currentTime,
+            referencePrices.getMids(), ledger,
+            orderBook.newOrderIds(simulation.getOrderIdCount()), rejected);
+        generateMillis += millisSince(start);
+
+        start = Clock::now();
+        orderBook.insertOrders(batch);
+        for (const OrderBookEntry& order : batch)
+        {
+            feedLiveCandles(order);
+        }
+        insertMillis += millisSince(start);
+        orders += batch.size();
+
+        // Matching, settlement, and expiry of what is left of the batch
+        start = Clock::now();
+        trades += gotoNextTimeframe();
+        matchMillis += millisSince(start);
+    }
+    double totalMillis = millisSince(runStart);
+
+    std::cout << "\n========== SIMULATION RESULTS ==========" << std::endl;
+    std::cout << "Agents:        " << simulation.getAgentCount() << std::endl;
+    std::cout << "Timeframes:    " << config.timeframes << std::endl;
+    std::cout << "Orders placed: " << orders << std::endl;
+    std::cout << "Rejected:      " << rejected << " (insufficient funds)" << std::endl;
+    std::cout << "Trades:        " << trades << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Generate:      " << generateMillis << " ms" << std::endl;
+    std::cout << "Insert:        " << insertMillis << " ms" << std::endl;
+    std::cout << "Match+settle:  " << matchMillis << " ms" << std::endl;
+    std::cout << "Total:         " << totalMillis << " ms" << std::endl;
+    if (totalMillis > 0)
+    {
+        std::cout << std::setprecision(0);
+        std::cout << "Throughput:    " << orders / (totalMillis / 1000.0) << " orders/s, "
+            << trades / (totalMillis / 1000.0) << " trades/s" << std::endl;
+    }
+    std::cout << "Current time:  " << currentTime << std::endl;
+}
+
+void MerkelMain::placeAsk()
+{
+    std::cout << "\n========== PLACE ASK (SELL ORDER) ==========" << std::endl;
+
+    std::string product = getValidatedProductInput();
+    double price = getValidatedDoubleInput("Enter price: ");
+    double amount = getValidatedDoubleInput("Enter amount: ");
+
+    if (price <= 0 || amount <= 0)
+    {
+        std::cout << "Price and amount must be positive." << std::endl;
+        return;
+    }
+
+    // Stamped with the replay's current timeframe so the order matches when
+    // it is advanced, like server and script orders
+    if (placeOrder(currentUser.getUsername(), OrderBookType::ask, product, price, amount,
+        currentTime))
+    {
+        std::cout << "\nAsk order placed successfully!" << std::endl;
+    }
+    else
+    {
+        std::cout << "\nInsufficient funds in wallet." << std::endl;
+    }
+}
+
+void MerkelMain::placeBid()
+{
+    std::cout << "\n========== PLACE BID (BUY ORDER) ==========" << std::endl;
+
+    std::string product = getValidatedProductInput();
+    double price = getValidatedDoubleInput("Enter price: ");
+    double amount = getValidatedDoubleInput("Enter amount: ");
+
+    if (price <= 0 || amount <= 0)
+    {
+        std::cout << "Price and amount must be positive." << std::endl;
+        return;
+    }
+
+    // Stamped with the replay's current timeframe so the order matches when
+    // it is advanced, like server and script orders
+    if (placeOrder(currentUser.getUsername(), OrderBookType::bid, product, price, amount,
+        currentTime))
+    {
+        std::cout << "\nBid order placed successfully!" << std::endl;
+    }
+    else
+    {
+        std::cout << "\nInsufficient funds in wallet." << std::endl;
+    }
+}
+
+unsigned long long MerkelMain::placeOrder(const std::string& account, OrderBookType type,
+    const std::string& product, double price, double amount, const std::string& timestamp)
+{
+    OrderBookEntry obe(price, amount, timestamp, product,
+        type, account);
+    obe.orderId = orderBook.newOrderId();
+
+    // Funds stay reserved until the order fills or expires
+    if (!ledger.reserve(account, obe))
+    {
+        return 0;
+    }
+
+    orderBook.insertOrder(obe);
+    feedLiveCandles(obe);
+
+    TransactionType placed = (type == OrderBookType::ask) ?
+        TransactionType::ASK_PLACED : TransactionType::BID_PLACED;
+    Transaction trans(account, timestamp, placed,
+        product, amount, price, 0.0);
+    dataManager.saveTransaction(trans);
+    return obe.orderId;
+}
+
+// ==================== TASK 5: INPUT VALIDATION ====================
+
+std::string MerkelMain::getValidatedStringInput(std::string prompt)
+{
+    std::string input;
+    while (true)
+    {
+        std::cout << prompt;
+        std::getline(std::cin, input);
+
+        // Remove leading/trailing whitespace
+        input.erase(0, input.find_first_not_of(" \t\n\r"));
+        input.erase(input.find_last_not_of(" \t\n\r") + 1);
+
+        if (!input.empty())
+        {
+            return input;
+        }
+        std::cout << "Input cannot be empty. Please try again." << std::endl;
+    }
+}
+
+double MerkelMain::getValidatedDoubleInput(std::string prompt)
+{
+    std::string input;
+    double value;
+
+    while (true)
+    {
+        std::cout << prompt;
+        std::getline(std::cin, input);
+
+        if (input.empty())
+        {
+            std::cout << "Input cannot be empty. Please try again." << std::endl;
+            continue;
+        }
+
+        try
+        {
+            value = std::stod(input);
+
+            // Check for NaN and infinity
+            if (std::isnan(value) || std::isinf(value))
+            {
+                std::cout << "Invalid number. Please enter a valid decimal number." << std::endl;
+                continue;
+            }
+
+            return value;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Invalid number. Please enter a valid decimal number." << std::endl;
+        }
+    }
+}
+
+int MerkelMain::getValidatedIntInput(std::string prompt, int min, int max)
+{
+    std::string input;
+    int value;
+
+    while (true)
+    {
+        std::cout << prompt;
+        std::getline(std::cin, input);
+
+        try
+        {
+            value = std::stoi(input);
+
+            if (value >= min && value <= max)
+            {
+                return value;
+            }
+            std::cout << "Please enter a number between " << min << " and " << max << ": ";
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Invalid input. Please enter a number between " << min << " and " << max << ": ";
+        }
+    }
+}
+
+std::string MerkelMain::getValidatedProductInput()
+{
+    std::vector<std::string> knownProducts = orderBook.getKnownProducts();
+
+    std::cout << "\nAvailable products:" << std::endl;
+    for (size_t i = 0; i < knownProducts.size(); i++)
+    {
+        std::cout << (i + 1) << ": " << knownProducts[i] << std::endl;
+    }
+
+    int choice = getValidatedIntInput("Enter product number: ", 1, knownProducts.size());
+    return knownProducts[choice - 1];
+}
+
+std::string MerkelMain::getValidatedCurrencyInput(std::string prompt)
+{
+    std::vector<std::string> validCurrencies = getKnownCurrencies();
+    std::string currency;
+
+    while (true)
+    {
+        std::cout << prompt;
+        std::cout << "\nAvailable currencies: ";
+        for (size_t i = 0; i < validCurrencies.size(); i++)
+        {
+            std::cout << validCurrencies[i];
+            if (i < validCurrencies.size() - 1) std::cout << ", ";
+        }
+        std::cout << "\nEnter currency: ";
+
+        std::getline(std::cin, currency);
+
+        // Remove whitespace
+        currency.erase(0, currency.find_first_not_of(" \t\n\r"));
+        currency.erase(currency.find_last_not_of(" \t\n\r") + 1);
+
+        if (currency.empty())
+        {
+            std::cout << "Currency cannot be empty. Please try again.\n" << std::endl;
+            continue;
+        }
+
+        // Convert to uppercase for validation
+        std::transform(currency.begin(), currency.end(), currency.begin(), ::toupper);
+
+        if (isValidCurrency(currency))
+        {
+            return currency;
+        }
+
+        std::cout << "Invalid currency. Please enter one of the available currencies.\n" << std::endl;
+    }
+}
+
+bool MerkelMain::validateEmail(std::string email)
+{
+    const std::regex pattern("^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$");
+    return std::regex_match(email, pattern);
+}
+
+bool MerkelMain::isValidCurrency(std::string currency)
+{
+    std::vector<std::string> validCurrencies = getKnownCurrencies();
+
+    // Convert to uppercase for comparison
+    std::transform(currency.begin(), currency.end(), currency.begin(), ::toupper);
+
+    for (const std::string& valid : validCurrencies)
+    {
+        if (currency == valid)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> MerkelMain::getKnownCurrencies()
+{
+    // Extract unique currencies from all product pairs
+    std::vector<std::string> currencies;
+    std::vector<std::string> products = orderBook.getKnownProducts();
+
+    for (const std::string& product : products)
+    {
+        size_t slashPos = product.find('/');
+        if (slashPos != std::string::npos)
+        {
+            std::string currency1 = product.substr(0, slashPos);
+            std::string currency2 = product.substr(slashPos + 1);
+
+            // Add unique currencies
+            if (std::find(currencies.begin(), currencies.end(), currency1) == currencies.end())
+            {
+                currencies.push_back(currency1);
+            }
+            if (std::find(currencies.begin(), currencies.end(), currency2) == currencies.end())
+            {
+                currencies.push_back(currency2);
+            }
+        }
+    }
+
+    return currencies;
+}
+
+// ==================== HELPER FUNCTIONS ====================
+
+void MerkelMain::printMarketStats()
+{
+    std::cout << "\n========== MARKET STATISTICS ==========" << std::endl;
+
+    for (const std::string& product : orderBook.getKnownProducts())
+    {
+        std::cout << "\n--- " << product << " ---" << std::endl;
+
+        std::vector<OrderBookEntry> asks = orderBook.getOrders(OrderBookType::ask,
+            product, currentTime);
+        std::vector<OrderBookEntry> bids = orderBook.getOrders(OrderBookType::bid,
+            product, currentTime);
+
+        std::cout << "Asks available: " << asks.size() << std::endl;
+        if (!asks.empty())
+        {
+            std::cout << std::fixed << std::setprecision(8);
+            std::cout << "  Max ask: " << OrderBook::getHighPrice(asks) << std::endl;
+            std::cout << "  Min ask: " << OrderBook::getLowPrice(asks) << std::endl;
+        }
+
+        std::cout << "Bids available: " << bids.size() << std::endl;
+        if (!bids.empty())
+        {
+            std::cout << std::fixed << std::setprecision(8);
+            std::cout << "  Max bid: " << OrderBook::getHighPrice(bids) << std::endl;
+            std::cout << "  Min bid: " << OrderBook::getLowPrice(bids) << std::endl;
+        }
+    }
+}
+
+size_t MerkelMain::gotoNextTimeframe()
+{
+    if (!quiet) std::cout << "\nAdvancing to next timeframe..." << std::endl;
+
+    std::vector<Trade> trades;
+    for (std::string& product : orderBook.getKnownProducts())
+    {
+        if (!quiet) std::cout << "Matching " << product << "..." << std::endl;
+        std::vector<Trade> matched = orderBook.matchTrades(product, currentTime);
+
+        if (!quiet) std::cout << "Sales: " << matched.size() << std::endl;
+
+        trades.insert(trades.end(), matched.begin(), matched.end());
+    }
+
+    // Settle every participant of the timeframe at once, shard by shard; only
+    // logged-in users' balances are persisted. Refused trades leave the list
+    // and are not logged as fills
+    size_t refused = 0;
+    std::map<std::string, std::map<std::string, double>> changed = ledger.settle(trades, refused);
+    if (refused > 0 && !quiet)
+    {
+        std::cout << "Refused " << refused << " trades with no funds reserved behind them" << std::endl;
+    }
+    for (const auto& account : changed)
+    {
+        if (sessionUsers.count(account.first))
+        {
+            dataManager.saveWallet(account.first, account.second);
+        }
+    }
+
+    for (const Trade& trade : trades)
+    {
+        if (sessionUsers.count(trade.buyer))
+        {
+            Transaction trans(trade.buyer, trade.timestamp, TransactionType::BID_FILLED,
+                trade.product, trade.amount, trade.price, 0.0);
+            dataManager.saveTransaction(trans);
+        }
+        if (sessionUsers.count(trade.seller))
+        {
+            Transaction trans(trade.seller, trade.timestamp, TransactionType::ASK_FILLED,
+                trade.product, trade.amount, trade.price, 0.0);
+            dataManager.saveTransaction(trans);
+        }
+    }
+
+    // Orders only match in the timeframe they were placed in; as they expire
+    // they leave the book and release whatever they still hold
+    for (const OrderBookEntry& order : orderBook.expireOrders(currentTime))
+    {
+        ledger.release(order.username, order.orderId);
+    }
+
+    currentTime = orderBook.getNextTime(currentTime);
+    referencePrices.update(orderBook.getAllOrders(), currentTime);
+    advanceLiveCandles();
+
+    if (!quiet) std::cout << "New timeframe: " << currentTime << std::endl;
+    return trades.size();
+}
+
+void MerkelMain::saveCurrentWalletState()
+{
+    saveWalletState(currentUser.getUsername());
+}
+
+void MerkelMain::saveWalletState(const std::string& username)
+{
+    dataManager.saveWallet(username, ledger.getWallet(username).getBalances());
+}
+
+void MerkelMain::loadUserWallet()
+{
+    loadWallet(currentUser.getUsername());
+}
+
+void MerkelMain::loadWallet(const std::string& username)
+{
+    // A freshly registered account is already open in the ledger
+    if (ledger.hasAccount(username))
+    {
+        return;
+    }
+
+    std::map<std::string, double> walletData = dataManager.loadWalletBalance(username);
+
+    for (const auto& pair : walletData)
+    {
+        ledger.deposit(username, pair.first, pair.second);
+    }
+
+    // Initialize with default values if wallet is empty
+    if (walletData.empty())
+    {
+        ledger.deposit(username, "USDT", 10000.0);
+        ledger.deposit(username, "BTC", 0.5);
+        ledger.deposit(username, "ETH", 5.0);
+        saveWalletState(username);
+    }
+}
+
+std::string MerkelMain::getCurrentTimestamp()
+{
+    auto now = std::chrono::system_clock::now();
+    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+
+#pragma warning(suppress : 4996)
+    std::tm* now_tm = std::localtime(&now_c);
+
+    char buffer[100];
+    std::strftime(buffer, sizeof(buffer), "%Y/%m/%d %H:%M:%S", now_tm);
+
+    return std::string(buffer);
+}
+
+// ==================== SCRIPT MODE ====================
+
+bool MerkelMain::runScript(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "MerkelMain::runScript: cannot open " << filename << std::endl;
+        return false;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    struct Timing
+    {
+        int count = 0;
+        double millis = 0.0;
+    };
+    std::map<std::string, Timing> timings;
+
+    quiet = true;
+    bool ok = true;
+    int lineNumber = 0;
+    std::string line;
+    Clock::time_point scriptStart = Clock::now();
+
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+
+        // One command per line, arguments separated by spaces; # starts a comment
+        std::istringstream tokens(line.substr(0, line.find('#')));
+        std::vector<std::string> args;
+        std::string token;
+        while (tokens >> token)
+        {
+            args.push_back(token);
+        }
+        if (args.empty())
+        {
+            continue;
+        }
+
+        std::cout << "\n> " << line << std::endl;
+
+        Clock::time_point start = Clock::now();
+        bool done = runScriptCommand(args);
+        double millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        Timing& timing = timings[args[0]];
+        timing.count++;
+        timing.millis += millis;
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "[" << args[0] << ": " << millis << " ms]" << std::endl;
+
+        if (!done)
+        {
+            std::cout << "Script line " << lineNumber << " failed: " << line << std::endl;
+            ok = false;
+        }
+    }
+
+    dataManager.flush();
+    double totalMillis = std::chrono::duration<double, std::milli>(Clock::now() - scriptStart).count();
+
+    std::cout << "\n========== SCRIPT TIMING ==========" << std::endl;
+    std::cout << std::left << std::setw(12) << "Command"
+        << std::right << std::setw(8) << "Count"
+        << std::setw(14) << "Total ms"
+        << std::setw(14) << "Mean ms" << std::endl;
+    std::cout << std::string(48, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& pair : timings)
+    {
+        std::cout << std::left << std::setw(12) << pair.first
+            << std::right << std::setw(8) << pair.second.count
+            << std::setw(14) << pair.second.millis
+            << std::setw(14) << pair.second.millis / pair.second.count << std::endl;
+    }
+    std::cout << std::string(48, '-') << std::endl;
+    std::cout << "Total: " << totalMillis << " ms" << std::endl;
+
+    quiet = false;
+    return ok;
+}
+
+bool MerkelMain::runScriptCommand(const std::vector<std::string>& args)
+{
+    const std::string& command = args[0];
+
+    auto number = [&](size_t index, double& value)
+    {
+        try
+        {
+            value = std::stod(args.at(index));
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Expected a number for argument " << index << std::endl;
+            return false;
+        }
+    };
+
+    // login <username> <password>
+    if (command == "login" && args.size() == 3)
+    {
+        if (!authenticate(args[1], args[2])) return false;
+        loadUserWallet();
+        return true;
+    }
+
+    // register <email> <password> <full name...>
+    if (command == "register" && args.size() >= 4)
+    {
+        std::string fullName = args[3];
+        for (size_t i = 4; i < args.size(); i++)
+        {
+            fullName += " " + args[i];
+        }
+        if (!validateEmail(args[1]) || dataManager.userExists(args[1], fullName))
+        {
+            std::cout << "Invalid or already registered email." << std::endl;
+            return false;
+        }
+        return createUser(fullName, args[1], args[2]);
+    }
+
+    // next [count]
+    if (command == "next" && args.size() <= 2)
+    {
+        double count = 1;
+        if (args.size() == 2 && !number(1, count)) return false;
+        for (int i = 0; i < (int)count; i++)
+        {
+            gotoNextTimeframe();
+        }
+        std::cout << "Current time: " << currentTime << std::endl;
+        return true;
+    }
+
+    if (command == "market" && args.size() == 1)
+    {
+        printMarketStats();
+        return true;
+    }
+
+    // candles <product> <interval>
+    if (command == "candles" && args.size() == 3)
+    {
+        CandleInterval interval;
+        if (!CandleInterval::parse(args[2], interval))
+        {
+            std::cout << "Unknown interval: " << args[2] << std::endl;
+            return false;
+        }
+        showCandlestickData(args[1], interval);
+        return true;
+    }
+
+    // simulate <agents of each kind> <timeframes> [seed] [threads]
+    if (command == "simulate" && args.size() >= 3 && args.size() <= 5)
+    {
+        double agents = 0, timeframes = 0, seed = 1, threads = 0;
+        if (!number(1, agents) || !number(2, timeframes)) return false;
+        if (args.size() >= 4 && !number(3, seed)) return false;
+        if (args.size() == 5 && !number(4, threads)) return false;
+        if (agents < 0 || timeframes < 1 || seed < 0 || threads < 0) return false;
+
+        AgentSimulation::Config config;
+        config.marketMakers = (int)agents;
+        config.takers = (int)agents;
+        config.randomWalkers = (int)agents;
+        config.timeframes = (int)timeframes;
+        config.seed = (std::uint64_t)seed;
+        config.threads = (unsigned)threads;
+        runAgentSimulation(config);
+        return true;
+    }
+
+    // Everything below acts on the logged-in user
+    bool userCommand = command == "deposit" || command == "withdraw" || command == "ask" ||
+        command == "bid" || command == "wallet" || command == "stats";
+    if (userCommand && !isLoggedIn())
+    {
+        std::cout << "'" << command << "' needs a login first." << std::endl;
+        return false;
+    }
+
+    // deposit|withdraw <currency> <amount>
+    if ((command == "deposit" || command == "withdraw") && args.size() == 3)
+    {
+        double amount = 0.0;
+        if (!number(2, amount) || amount <= 0) return false;
+        if (command == "deposit")
+        {
+            deposit(args[1], amount);
+            return true;
+        }
+        if (!withdraw(args[1], amount))
+        {
+            std::cout << "Insufficient funds in wallet." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // ask|bid <product> <price> <amount>
+    if ((command == "ask" || command == "bid") && args.size() == 4)
+    {
+        double price = 0.0, amount = 0.0;
+        if (!number(2, price) || !number(3, amount) || price <= 0 || amount <= 0) return false;
+        if (!orderBook.isKnownProduct(args[1]))
+        {
+            std::cout << "Unknown product: " << args[1] << std::endl;
+            return false;
+        }
+        OrderBookType type = command == "ask" ? OrderBookType::ask : OrderBookType::bid;
+        if (!placeOrder(currentUser.getUsername(), type, args[1], price, amount, currentTime))
+        {
+            std::cout << "Insufficient funds in wallet." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (command == "wallet" && args.size() == 1)
+    {
+        viewWalletBalance();
+        return true;
+    }
+
+    if (command == "stats" && args.size() == 1)
+    {
+        viewUserStatistics();
+        return true;
+    }
+
+    std::cout << "Unknown command or wrong arguments: " << command << std::endl;
+    return false;
+}
+
+// ==================== SERVER MODE ====================
+
+bool MerkelMain::runServer(const std::string& address)
+{
+    if (!TradingServer::isSupported())
+    {
+        std::cout << "Server mode is only available on Linux." << std::endl;
+        return false;
+    }
+
+    TradingServer server(*this);
+    if (!server.listen(address))
+    {
+        return false;
+    }
+
+    std::cout << "Serving on " << address << " at " << currentTime << " (Ctrl+C to stop)" << std::endl;
+    quiet = true;
+    bool ok = server.run();
+    quiet = false;
+
+    dataManager.flush();
+    std::cout << "Server stopped at " << currentTime << std::endl;
+    return ok;
+}
+
+bool MerkelMain::serverLogin(const std::string& username, const std::string& password)
+{
+    User user = dataManager.loadUser(username);
+    if (user.getUsername().empty() || User::hashPassword(password) != user.getPasswordHash())
+    {
+        return false;
+    }
+
+    // Another process trading for the same user would overwrite its wallet
+    if (!dataManager.claimUser(username))
+    {
+        return false;
+    }
+
+    sessionUsers.insert(username);
+    loadWallet(username);
+    return true;
+}
+
+unsigned long long MerkelMain::serverPlaceOrder(const std::string& account, OrderBookType type,
+    const std::string& product, double price, double amount)
+{
+    // Checked before placing: insertOrder would add an unseen product
+    if (!orderBook.isKnownProduct(product))
+    {
+        return 0;
+    }
+
+    // Server orders join the replay's current timeframe, so they match when
+    // it is advanced
+    return placeOrder(account, type, product, price, amount, currentTime);
+}
+
+bool MerkelMain::serverCancelOrder(const std::string& account, unsigned long long orderId)
+{
+    return ledger.cancel(orderBook, account, orderId);
+}
+
+Wallet MerkelMain::serverGetWallet(const std::string& account)
+{
+    return ledger.getWallet(account);
+}
+
+TradingServer::Quote MerkelMain::serverGetQuote(const std::string& product)
+{
+    TradingServer::Quote quote{ currentTime, 0.0, 0.0, 0, 0 };
+
+    // Orders are sorted by timestamp, so the timeframe is one contiguous range
+    const std::vector<OrderBookEntry>& orders = orderBook.getAllOrders();
+    auto first = std::lower_bound(orders.begin(), orders.end(), currentTime,
+        [](const OrderBookEntry& order, const std::string& time) { return order.timestamp < time; });
+
+    for (auto it = first; it != orders.end() && it->timestamp == currentTime; ++it)
+    {
+        if (it->product != product) continue;
+
+        if (it->orderType == OrderBookType::bid)
+        {
+            if (quote.bids == 0 || it->price > quote.bestBid) quote.bestBid = it->price;
+            quote.bids++;
+        }
+        else if (it->orderType == OrderBookType::ask)
+        {
+            if (quote.asks == 0 || it->price < quote.bestAsk) quote.bestAsk = it->price;
+            quote.asks++;
+        }
+    }
+    return quote;
+}
+
+CandleSeries MerkelMain::serverGetCandles(const std::string& product,
+    const CandleInterval& interval, OrderBookType type)
+{
+    return getLiveCandles(product, interval, type);
+}
+
+std::string MerkelMain::serverAdvance()
+{
+    gotoNextTimeframe();
+    return currentTime;
 }
\ No newline at end of file
@@ -1,82 +1,136 @@
-// ==================== MerkelMain.h ====================
-/**
- * MerkelMain.h
- * Main application controller for cryptocurrency trading simulator
- * Handles user interface, authentication, wallet management, and trading operations
- */
-
-#pragma once
-#include <vector>
-#include <string>
-#include "OrderBookEntry.h"
-#include "OrderBook.h"
-#include "Wallet.h"
-#include "User.h"
-#include "DataManager.h"
-#include "Candlestick.h"
-#include "Transaction.h"
-
-class MerkelMain
-{
-public:
-    MerkelMain();
-    void init();
-
-private:
-    // ===== MENU FUNCTIONS =====
-    void printMainMenu();
-    void printHelpMenu();
-    int getUserOption();
-    void processUserOption(int userOption);
-
-    // ===== TASK 1: Candlestick Data =====
-    void displayCandlestickData();
-    void printCandlestickTable(const std::vector<Candlestick>& candlesticks, std::string type);
-
-    // ===== TASK 2: User Authentication =====
-    void loginOrRegister();
-    void registerNewUser();
-    void loginUser();
-    void forgotPassword();
-    bool isLoggedIn() const { return !currentUser.getUsername().empty(); }
-
-    // ===== TASK 3: Wallet & Transaction History =====
-    void manageWallet();
-    void depositFunds();
-    void withdrawFunds();
-    void viewWalletBalance();
-    void viewTransactionHistory();
-    void viewUserStatistics();
-
-    // ===== TASK 4: Trading Simulation =====
-    void simulateTrading();
-    void placeAsk();
-    void placeBid();
-    double calculateAskPrice(std::string product);
-    double calculateBidPrice(std::string product);
-    std::string getCurrentTimestamp();
-
-    // ===== TASK 5: Input Validation =====
-    std::string getValidatedStringInput(std::string prompt);
-    double getValidatedDoubleInput(std::string prompt);
-    int getValidatedIntInput(std::string prompt, int min, int max);
-    std::string getValidatedProductInput();
-    std::string getValidatedCurrencyInput(std::string prompt);
-    bool validateEmail(std::string email);
-    bool isValidCurrency(std::string currency);
-
-    // ===== Helper Functions =====
-    void printMarketStats();
-    void gotoNextTimeframe();
-    void saveCurrentWalletState();
-    void loadUserWallet();
-    std::vector<std::string> getKnownCurrencies();
-
-    // ===== Member Variables =====
-    std::string currentTime;
-    OrderBook orderBook;
-    Wallet wallet;
-    User currentUser;
-    DataManager dataManager;
-    bool isAuthenticated;
+// ==================== MerkelMain.h ====================
+/**
+ * MerkelMain.h
+ * Main application controller for cryptocurrency trading simulator
+ * Handles user interface, authentication, wallet management, and trading operations
+ */
+
+#pragma once
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include "OrderBookEntry.h"
+#include "OrderBook.h"
+#include "ReferencePrices.h"
+#include "AccountLedger.h"
+#include "AgentSimulation.h"
+#include "User.h"
+#include "DataManager.h"
+#include "Candlestick.h"
+#include "CandlestickCache.h"
+#include "IndicatorEngine.h"
+#include "Transaction.h"
+#include "TradingServer.h"
+
+class MerkelMain : private TradingServer::Handler
+{
+public:
+    MerkelMain();
+    void init();
+
+    // Runs a command file without prompts and reports how long each command
+    // took; false if the file cannot be read or a command fails
+    bool runScript(const std::string& filename);
+
+    // Serves the exchange to socket clients (Linux) until interrupted;
+    // address is "unix:<path>" or "tcp:<port>"
+    bool runServer(const std::string& address);
+
+private:
+    // ===== MENU FUNCTIONS =====
+    void printMainMenu();
+    void printHelpMenu();
+    int getUserOption();
+    void processUserOption(int userOption);
+
+    // ===== TASK 1: Candlestick Data =====
+    void displayCandlestickData();
+    void showCandlestickData(const std::string& product, const CandleInterval& interval);
+    void printCandlestickTable(const CandleSeries& candlesticks, std::string type);
+    void printIndicatorSummary(const IndicatorEngine& indicators, std::string type);
+    CandleInterval getValidatedIntervalInput();
+    CandleSeries getLiveCandles(const std::string& product, const CandleInterval& interval, OrderBookType type);
+    IndicatorEngine getLiveIndicators(const std::string& product, const CandleInterval& interval, OrderBookType type);
+    void loadLiveCandles(CandlestickPyramid& pyramid);
+    void feedLiveCandles(const OrderBookEntry& order);
+    void advanceLiveCandles();
+
+    // ===== TASK 2: User Authentication =====
+    void loginOrRegister();
+    void registerNewUser();
+    void loginUser();
+    void forgotPassword();
+    bool authenticate(const std::string& username, const std::string& password);
+    bool createUser(const std::string& fullName, const std::string& email, const std::string& password);
+    bool isLoggedIn() const { return !currentUser.getUsername().empty(); }
+
+    // ===== TASK 3: Wallet & Transaction History =====
+    void manageWallet();
+    void depositFunds();
+    void withdrawFunds();
+    double deposit(const std::string& currency, double amount);
+    bool withdraw(const std::string& currency, double amount);
+    void viewWalletBalance();
+    void viewTransactionHistory();
+    void viewUserStatistics();
+
+    // ===== TASK 4: Trading Simulation =====
+    void simulateTrading();
+    void runAgentSimulation(const AgentSimulation::Config& config);
+    void placeAsk();
+    void placeBid();
+    unsigned long long placeOrder(const std::string& account, OrderBookType type,
+        const std::string& product, double price, double amount, const std::string& timestamp);
+    std::string getCurrentTimestamp();
+
+    // ===== TASK 5: Input Validation =====
+    std::string getValidatedStringInput(std::string prompt);
+    double getValidatedDoubleInput(std::string prompt);
+    int getValidatedIntInput(std::string prompt, int min, int max);
+    std::string getValidatedProductInput();
+    std::string getValidatedCurrencyInput(std::string prompt);
+    bool validateEmail(std::string email);
+    bool isValidCurrency(std::string currency);
+
+    // ===== Helper Functions =====
+    void printMarketStats();
+    size_t gotoNextTimeframe();     // Returns the number of trades matched
+    void saveCurrentWalletState();
+    void saveWalletState(const std::string& username);
+    void loadUserWallet();
+    void loadWallet(const std::string& username);
+    std::vector<std::string> getKnownCurrencies();
+
+    // ===== Script Mode =====
+    bool runScriptCommand(const std::vector<std::string>& args);
+
+    // ===== Server Mode (TradingServer::Handler) =====
+    bool serverLogin(const std::string& username, const std::string& password) override;
+    unsigned long long serverPlaceOrder(const std::string& account, OrderBookType type,
+        const std::string& product, double price, double amount) override;
+    bool serverCancelOrder(const std::string& account, unsigned long long orderId) override;
+    Wallet serverGetWallet(const std::string& account) override;
+    TradingServer::Quote serverGetQuote(const std::string& product) override;
+    CandleSeries serverGetCandles(const std::string& product,
+        const CandleInterval& interval, OrderBookType type) override;
+    std::string serverAdvance() override;
+
+    // ===== Member Variables =====
+    std::string currentTime;
+    std::string replayedUntil;  // Latest timeframe fed to the live candles; survives wraps
+    OrderBook orderBook;
+    ReferencePrices referencePrices;    // Rolled forward with currentTime
+    AccountLedger ledger;   // Every account's balances, including currentUser's
+    User currentUser;
+    DataManager dataManager;
+    bool isAuthenticated;
+    bool quiet;     // Script/server mode: no per-product progress while advancing
+
+    // Users logged in to this process (the menu user and server clients);
+    // their fills are logged and their balances persisted
+    std::set<std::string> sessionUsers;
+
+    // Live candles, updated as the replay advances and orders are placed
+    CandlestickCache candleCache;
 };
\ No newline at end of file
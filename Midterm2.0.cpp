@@ -1,16 +1,31 @@
-// ==================== Main.cpp ====================
-/**
- * main.cpp
- * Entry point for Cryptocurrency Trading Simulator
- * Initializes and launches the main application
- */
-
-#include <iostream>
-#include "MerkelMain.h"
-
-int main()
-{
-    MerkelMain app{};
-    app.init();
-    return 0;
+// ==================== Main.cpp ====================
+/**
+ * main.cpp
+ * Entry point for Cryptocurrency Trading Simulator
+ * Initializes and launches the main application
+ */
+
+#include <iostream>
+#include <string>
+#include "MerkelMain.h"
+
+int main(int argc, char* argv[])
+{
+    MerkelMain app{};
+
+    // --script <file>: run commands from a file with no prompts (load tests,
+    // benchmarks); otherwise start the interactive menu
+    if (argc == 3 && std::string(argv[1]) == "--script")
+    {
+        return app.runScript(argv[2]) ? 0 : 1;
+    }
+
+    // --serve unix:<path> | tcp:<port>: trading server for local clients
+    if (argc == 3 && std::string(argv[1]) == "--serve")
+    {
+        return app.runServer(argv[2]) ? 0 : 1;
+    }
+
+    app.init();
+    return 0;
 }
\ No newline at end of file
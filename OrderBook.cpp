@@ -1,163 +1,287 @@
-// ==================== OrderBook.cpp ====================
-/**
- * OrderBook.cpp
- * Implementation of order book management
- */
-
-#include "OrderBook.h"
-#include "CSVReader.h"
-#include <map>
-#include <algorithm>
-#include <iostream>
-
-OrderBook::OrderBook(std::string filename)
-{
-    orders = CSVReader::readCSV(filename);
-}
-
-std::vector<std::string> OrderBook::getKnownProducts()
-{
-    std::vector<std::string> products;
-    std::map<std::string, bool> prodMap;
-
-    for (OrderBookEntry& e : orders)
-    {
-        prodMap[e.product] = true;
-    }
-
-    for (auto const& e : prodMap)
-    {
-        products.push_back(e.first);
-    }
-
-    return products;
-}
-
-std::vector<OrderBookEntry> OrderBook::getOrders(OrderBookType type,
-    std::string product,
-    std::string timestamp)
-{
-    std::vector<OrderBookEntry> orders_sub;
-    for (OrderBookEntry& e : orders)
-    {
-        if (e.orderType == type &&
-            e.product == product &&
-            e.timestamp == timestamp)
-        {
-            orders_sub.push_back(e);
-        }
-    }
-    return orders_sub;
-}
-
-double OrderBook::getHighPrice(std::vector<OrderBookEntry>& orders)
-{
-    double max = orders[0].price;
-    for (OrderBookEntry& e : orders)
-    {
-        if (e.price > max)
-            max = e.price;
-    }
-    return max;
-}
-
-double OrderBook::getLowPrice(std::vector<OrderBookEntry>& orders)
-{
-    double min = orders[0].price;
-    for (OrderBookEntry& e : orders)
-    {
-        if (e.price < min)
-            min = e.price;
-    }
-    return min;
-}
-
-std::string OrderBook::getEarliestTime()
-{
-    return orders[0].timestamp;
-}
-
-std::string OrderBook::getNextTime(std::string timestamp)
-{
-    std::string next_timestamp = "";
-    for (OrderBookEntry& e : orders)
-    {
-        if (e.timestamp > timestamp)
-        {
-            next_timestamp = e.timestamp;
-            break;
-        }
-    }
-
-    // Wrap around to start if no next time found
-    if (next_timestamp == "")
-    {
-        next_timestamp = orders[0].timestamp;
-    }
-    return next_timestamp;
-}
-
-void OrderBook::insertOrder(OrderBookEntry& order)
-{
-    orders.push_back(order);
-    std::sort(orders.begin(), orders.end(), OrderBookEntry::compareByTimestamp);
-}
-
-std::vector<OrderBookEntry> OrderBook::matchAsksToBids(std::string product, std::string timestamp)
-{
-    std::vector<OrderBookEntry> asks = getOrders(OrderBookType::ask, product, timestamp);
-    std::vector<OrderBookEntry> bids = getOrders(OrderBookType::bid, product, timestamp);
-    std::vector<OrderBookEntry> sales;
-
-    // Sort asks ascending, bids descending for matching
-    std::sort(asks.begin(), asks.end(), OrderBookEntry::compareByPriceAsc);
-    std::sort(bids.begin(), bids.end(), OrderBookEntry::compareByPriceDesc);
-
-    // Match orders
-    for (OrderBookEntry& ask : asks)
-    {
-        for (OrderBookEntry& bid : bids)
-        {
-            if (bid.price >= ask.price)
-            {
-                OrderBookEntry sale{ ask.price, 0, timestamp, product, OrderBookType::asksale };
-
-                if (bid.username == "simuser")
-                {
-                    sale.username = "simuser";
-                    sale.orderType = OrderBookType::bidsale;
-                }
-                if (ask.username == "simuser")
-                {
-                    sale.username = "simuser";
-                    sale.orderType = OrderBookType::asksale;
-                }
-
-                // Match amounts
-                if (bid.amount == ask.amount)
-                {
-                    sale.amount = ask.amount;
-                    sales.push_back(sale);
-                    bid.amount = 0;
-                    break;
-                }
-                if (bid.amount > ask.amount)
-                {
-                    sale.amount = ask.amount;
-                    sales.push_back(sale);
-                    bid.amount = bid.amount - ask.amount;
-                    break;
-                }
-                if (bid.amount < ask.amount && bid.amount > 0)
-                {
-                    sale.amount = bid.amount;
-                    sales.push_back(sale);
-                    ask.amount = ask.amount - bid.amount;
-                    bid.amount = 0;
-                    continue;
-                }
-            }
-        }
-    }
-    return sales;
+// ==================== OrderBook.cpp ====================
+/**
+ * OrderBook.cpp
+ * Implementation of order book management
+ */
+
+#include "OrderBook.h"
+#include "CSVReader.h"
+#include <map>
+#include <algorithm>
+#include <iostream>
+
+OrderBook::OrderBook(std::string filename)
+    : lastOrderId(0)
+{
+    orders = CSVReader::readCSV(filename);
+
+    std::map<std::string, bool> prodMap;
+    for (OrderBookEntry& e : orders)
+    {
+        prodMap[e.product] = true;
+    }
+    for (auto const& e : prodMap)
+    {
+        products.push_back(e.first);
+    }
+}
+
+std::vector<std::string> OrderBook::getKnownProducts()
+{
+    return products;
+}
+
+bool OrderBook::isKnownProduct(const std::string& product) const
+{
+    return std::binary_search(products.begin(), products.end(), product);
+}
+
+void OrderBook::addProduct(const std::string& product)
+{
+    auto it = std::lower_bound(products.begin(), products.end(), product);
+    if (it == products.end() || *it != product)
+    {
+        products.insert(it, product);
+    }
+}
+
+std::vector<OrderBookEntry>::iterator OrderBook::timeframeBegin(const std::string& timestamp)
+{
+    return std::lower_bound(orders.begin(), orders.end(), timestamp,
+        [](const OrderBookEntry& e, const std::string& t) { return e.timestamp < t; });
+}
+
+std::vector<OrderBookEntry>::iterator OrderBook::timeframeEnd(const std::string& timestamp)
+{
+    return std::upper_bound(orders.begin(), orders.end(), timestamp,
+        [](const std::string& t, const OrderBookEntry& e) { return t < e.timestamp; });
+}
+
+std::vector<OrderBookEntry> OrderBook::getOrders(OrderBookType type,
+    std::string product,
+    std::string timestamp)
+{
+    // Orders are kept in timestamp order, so only the timeframe's range is scanned
+    std::vector<OrderBookEntry> orders_sub;
+    auto end = timeframeEnd(timestamp);
+    for (auto it = timeframeBegin(timestamp); it != end; ++it)
+    {
+        if (it->orderType == type &&
+            it->product == product)
+        {
+            orders_sub.push_back(*it);
+        }
+    }
+    return orders_sub;
+}
+
+double OrderBook::getHighPrice(std::vector<OrderBookEntry>& orders)
+{
+    double max = orders[0].price;
+    for (OrderBookEntry& e : orders)
+    {
+        if (e.price > max)
+            max = e.price;
+    }
+    return max;
+}
+
+double OrderBook::getLowPrice(std::vector<OrderBookEntry>& orders)
+{
+    double min = orders[0].price;
+    for (OrderBookEntry& e : orders)
+    {
+        if (e.price < min)
+            min = e.price;
+    }
+    return min;
+}
+
+std::string OrderBook::getEarliestTime()
+{
+    return orders[0].timestamp;
+}
+
+std::string OrderBook::getNextTime(std::string timestamp)
+{
+    std::string next_timestamp = "";
+    auto next = timeframeEnd(timestamp);
+    if (next != orders.end())
+    {
+        next_timestamp = next->timestamp;
+    }
+
+    // Wrap around to start if no next time found
+    if (next_timestamp == "")
+    {
+        next_timestamp = orders[0].timestamp;
+    }
+    return next_timestamp;
+}
+
+void OrderBook::insertOrder(OrderBookEntry& order)
+{
+    // Goes after any order with the same timestamp, as the old stable append-and-sort did
+    orders.insert(timeframeEnd(order.timestamp), order);
+    addProduct(order.product);
+}
+
+void OrderBook::insertOrders(std::vector<OrderBookEntry>& batch)
+{
+    if (batch.empty())
+    {
+        return;
+    }
+
+    // Sort only the batch, then merge it in; equal timestamps keep the book's orders first
+    auto byTimestamp = [](const OrderBookEntry& e1, const OrderBookEntry& e2)
+    {
+        return e1.timestamp < e2.timestamp;
+    };
+    std::stable_sort(batch.begin(), batch.end(), byTimestamp);
+    size_t existing = orders.size();
+    orders.insert(orders.end(), batch.begin(), batch.end());
+    std::inplace_merge(orders.begin(), orders.begin() + existing, orders.end(), byTimestamp);
+
+    for (const OrderBookEntry& e : batch)
+    {
+        addProduct(e.product);
+    }
+}
+
+std::vector<OrderBookEntry> OrderBook::expireOrders(const std::string& timestamp)
+{
+    // Dataset orders have no ID and stay for the replay to wrap around to
+    auto begin = timeframeBegin(timestamp);
+    auto end = timeframeEnd(timestamp);
+    auto kept = std::stable_partition(begin, end, [](const OrderBookEntry& e)
+    {
+        return e.orderId == 0;
+    });
+    std::vector<OrderBookEntry> expired(std::make_move_iterator(kept), std::make_move_iterator(end));
+    orders.erase(kept, end);
+    return expired;
+}
+
+unsigned long long OrderBook::newOrderId()
+{
+    return newOrderIds(1);
+}
+
+unsigned long long OrderBook::newOrderIds(size_t count)
+{
+    unsigned long long first = lastOrderId + 1;
+    lastOrderId += count;
+    return first;
+}
+
+bool OrderBook::cancelOrder(unsigned long long orderId, const std::string& username)
+{
+    if (orderId == 0)
+    {
+        return false;
+    }
+
+    auto it = std::find_if(orders.begin(), orders.end(), [orderId](const OrderBookEntry& e)
+    {
+        return e.orderId == orderId;
+    });
+    if (it == orders.end() || it->username != username)
+    {
+        return false;
+    }
+
+    // erase keeps the remaining orders in timestamp order
+    orders.erase(it);
+    return true;
+}
+
+std::vector<Trade> OrderBook::matchTrades(std::string product, std::string timestamp)
+{
+    std::vector<OrderBookEntry> asks = getOrders(OrderBookType::ask, product, timestamp);
+    std::vector<OrderBookEntry> bids = getOrders(OrderBookType::bid, product, timestamp);
+    std::vector<Trade> trades;
+
+    // Sort asks ascending, bids descending for matching
+    std::sort(asks.begin(), asks.end(), OrderBookEntry::compareByPriceAsc);
+    std::sort(bids.begin(), bids.end(), OrderBookEntry::compareByPriceDesc);
+
+    // Match orders. Filled bids are always a prefix of the sorted bids, so each
+    // ask starts after them and stops at the first bid priced below it. Empty
+    // orders never trade.
+    size_t firstBid = 0;
+    for (OrderBookEntry& ask : asks)
+    {
+        if (ask.amount <= 0)
+        {
+            continue;
+        }
+        while (firstBid < bids.size() && bids[firstBid].amount <= 0)
+        {
+            ++firstBid;
+        }
+        if (firstBid == bids.size() || bids[firstBid].price < ask.price)
+        {
+            break;
+        }
+
+        for (size_t b = firstBid; b < bids.size(); ++b)
+        {
+            OrderBookEntry& bid = bids[b];
+            if (bid.price < ask.price)
+            {
+                break;
+            }
+
+            Trade trade{ ask.price, 0, timestamp, product, bid.username, ask.username,
+                bid.orderId, ask.orderId };
+
+            // Match amounts
+            if (bid.amount == ask.amount)
+            {
+                trade.amount = ask.amount;
+                trades.push_back(trade);
+                bid.amount = 0;
+                break;
+            }
+            if (bid.amount > ask.amount)
+            {
+                trade.amount = ask.amount;
+                trades.push_back(trade);
+                bid.amount = bid.amount - ask.amount;
+                break;
+            }
+            if (bid.amount < ask.amount && bid.amount > 0)
+            {
+                trade.amount = bid.amount;
+                trades.push_back(trade);
+                ask.amount = ask.amount - bid.amount;
+                bid.amount = 0;
+                continue;
+            }
+        }
+    }
+    return trades;
+}
+
+std::vector<OrderBookEntry> OrderBook::matchAsksToBids(std::string product, std::string timestamp)
+{
+    std::vector<OrderBookEntry> sales;
+    for (const Trade& trade : matchTrades(product, timestamp))
+    {
+        OrderBookEntry sale{ trade.price, trade.amount, timestamp, product, OrderBookType::asksale };
+
+        if (trade.buyer == "simuser")
+        {
+            sale.username = "simuser";
+            sale.orderType = OrderBookType::bidsale;
+        }
+        if (trade.seller == "simuser")
+        {
+            sale.username = "simuser";
+            sale.orderType = OrderBookType::asksale;
+        }
+        sales.push_back(sale);
+    }
+    return sales;
 }
\ No newline at end of file
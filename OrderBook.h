@@ -1,34 +1,70 @@
-// ==================== OrderBook.h ====================
-/**
- * OrderBook.h
- * Manages the collection of all trading orders
- */
-
-#pragma once
-#include "OrderBookEntry.h"
-#include "CSVReader.h"
-#include <string>
-#include <vector>
-
-class OrderBook
-{
-public:
-    OrderBook(std::string filename);
-
-    std::vector<std::string> getKnownProducts();
-    std::vector<OrderBookEntry> getOrders(OrderBookType type,
-        std::string product,
-        std::string timestamp);
-
-    std::string getEarliestTime();
-    std::string getNextTime(std::string timestamp);
-
-    void insertOrder(OrderBookEntry& order);
-    std::vector<OrderBookEntry> matchAsksToBids(std::string product, std::string timestamp);
-
-    static double getHighPrice(std::vector<OrderBookEntry>& orders);
-    static double getLowPrice(std::vector<OrderBookEntry>& orders);
-
-private:
-    std::vector<OrderBookEntry> orders;
-};
+// ==================== OrderBook.h ====================
+/**
+ * OrderBook.h
+ * Manages the collection of all trading orders
+ */
+
+#pragma once
+#include "OrderBookEntry.h"
+#include "CSVReader.h"
+#include "Trade.h"
+#include <string>
+#include <vector>
+
+class OrderBook
+{
+public:
+    OrderBook(std::string filename);
+
+    std::vector<std::string> getKnownProducts();
+
+    // Binary search of the sorted product list; check before inserting an
+    // order, since insertOrder adds any product it has not seen
+    bool isKnownProduct(const std::string& product) const;
+    std::vector<OrderBookEntry> getOrders(OrderBookType type,
+        std::string product,
+        std::string timestamp);
+
+    // Every order in timestamp order, without copying
+    const std::vector<OrderBookEntry>& getAllOrders() const { return orders; }
+
+    std::string getEarliestTime();
+    std::string getNextTime(std::string timestamp);
+
+    void insertOrder(OrderBookEntry& order);
+
+    // Adds many orders with one sort of the batch and one merge, instead of a
+    // full sort per order; the batch is left sorted by timestamp
+    void insertOrders(std::vector<OrderBookEntry>& batch);
+
+    // Drops the user orders left at a timeframe once it has been matched, so a
+    // replay that wraps around does not fill them again; returns the orders
+    // removed, so their reservations can be released
+    std::vector<OrderBookEntry> expireOrders(const std::string& timestamp);
+
+    // Next ID for a user order; set it before the order's funds are reserved
+    unsigned long long newOrderId();
+
+    // Reserves a block of count consecutive IDs and returns the first
+    unsigned long long newOrderIds(size_t count);
+
+    // Removes one of the user's orders; false if they have no order with that ID.
+    // AccountLedger::cancel also releases the order's funds
+    bool cancelOrder(unsigned long long orderId, const std::string& username);
+    std::vector<OrderBookEntry> matchAsksToBids(std::string product, std::string timestamp);
+
+    // Same matching, keeping the buyer and seller of every trade
+    std::vector<Trade> matchTrades(std::string product, std::string timestamp);
+
+    static double getHighPrice(std::vector<OrderBookEntry>& orders);
+    static double getLowPrice(std::vector<OrderBookEntry>& orders);
+
+private:
+    std::vector<OrderBookEntry>::iterator timeframeBegin(const std::string& timestamp);
+    std::vector<OrderBookEntry>::iterator timeframeEnd(const std::string& timestamp);
+    void addProduct(const std::string& product);
+
+    std::vector<OrderBookEntry> orders;
+    std::vector<std::string> products;  // Sorted, kept up to date on insert
+    unsigned long long lastOrderId;
+};
@@ -1,35 +1,40 @@
-// ==================== OrderBookEntry.cpp ====================
-/**
- * OrderBookEntry.cpp
- * Implementation of order book entry
- */
-
-#include "OrderBookEntry.h"
-
-OrderBookEntry::OrderBookEntry(double _price,
-    double _amount,
-    std::string _timestamp,
-    std::string _product,
-    OrderBookType _orderType,
-    std::string _username)
-    : price(_price),
-    amount(_amount),
-    timestamp(_timestamp),
-    product(_product),
-    orderType(_orderType),
-    username(_username)
-{
-}
-
-OrderBookType OrderBookEntry::stringToOrderBookType(std::string s)
-{
-    if (s == "ask")
-    {
-        return OrderBookType::ask;
-    }
-    if (s == "bid")
-    {
-        return OrderBookType::bid;
-    }
-    return OrderBookType::unknown;
+// ==================== OrderBookEntry.cpp ====================
+/**
+ * OrderBookEntry.cpp
+ * Implementation of order book entry
+ */
+
+#include "OrderBookEntry.h"
+#include "CurrencyRegistry.h"
+
+OrderBookEntry::OrderBookEntry(double _price,
+    double _amount,
+    std::string _timestamp,
+    std::string _product,
+    OrderBookType _orderType,
+    std::string _username)
+    : price(_price),
+    amount(_amount),
+    timestamp(_timestamp),
+    product(_product),
+    orderType(_orderType),
+    username(_username),
+    orderId(0)
+{
+    CurrencyRegistry::ProductIds ids = CurrencyRegistry::resolveProduct(product);
+    baseCurrency = ids.base;
+    quoteCurrency = ids.quote;
+}
+
+OrderBookType OrderBookEntry::stringToOrderBookType(std::string s)
+{
+    if (s == "ask")
+    {
+        return OrderBookType::ask;
+    }
+    if (s == "bid")
+    {
+        return OrderBookType::bid;
+    }
+    return OrderBookType::unknown;
 }
\ No newline at end of file
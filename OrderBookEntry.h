@@ -1,51 +1,59 @@
-// ==================== OrderBookEntry.h ====================
-/**
- * OrderBookEntry.h
- * Represents a single order in the order book
- */
-
-#pragma once
-#include <string>
-
-enum class OrderBookType
-{
-    bid,
-    ask,
-    unknown,
-    asksale,
-    bidsale
-};
-
-class OrderBookEntry
-{
-public:
-    OrderBookEntry(double _price,
-        double _amount,
-        std::string _timestamp,
-        std::string _product,
-        OrderBookType _orderType,
-        std::string _username = "dataset");
-
-    static OrderBookType stringToOrderBookType(std::string s);
-
-    // Comparators for sorting
-    static bool compareByTimestamp(OrderBookEntry& e1, OrderBookEntry& e2)
-    {
-        return e1.timestamp < e2.timestamp;
-    }
-    static bool compareByPriceAsc(OrderBookEntry& e1, OrderBookEntry& e2)
-    {
-        return e1.price < e2.price;
-    }
-    static bool compareByPriceDesc(OrderBookEntry& e1, OrderBookEntry& e2)
-    {
-        return e1.price > e2.price;
-    }
-
-    double price;
-    double amount;
-    std::string timestamp;
-    std::string product;
-    OrderBookType orderType;
-    std::string username;
+// ==================== OrderBookEntry.h ====================
+/**
+ * OrderBookEntry.h
+ * Represents a single order in the order book
+ */
+
+#pragma once
+#include <string>
+
+enum class OrderBookType
+{
+    bid,
+    ask,
+    unknown,
+    asksale,
+    bidsale
+};
+
+class OrderBookEntry
+{
+public:
+    OrderBookEntry(double _price,
+        double _amount,
+        std::string _timestamp,
+        std::string _product,
+        OrderBookType _orderType,
+        std::string _username = "dataset");
+
+    static OrderBookType stringToOrderBookType(std::string s);
+
+    // Comparators for sorting
+    static bool compareByTimestamp(OrderBookEntry& e1, OrderBookEntry& e2)
+    {
+        return e1.timestamp < e2.timestamp;
+    }
+    static bool compareByPriceAsc(OrderBookEntry& e1, OrderBookEntry& e2)
+    {
+        return e1.price < e2.price;
+    }
+    static bool compareByPriceDesc(OrderBookEntry& e1, OrderBookEntry& e2)
+    {
+        return e1.price > e2.price;
+    }
+
+    double price;
+    double amount;
+    std::string timestamp;
+    std::string product;
+    OrderBookType orderType;
+    std::string username;
+
+    // Assigned by OrderBook::newOrderId for orders placed by users, so fills
+    // and cancellations can find the order's reservation; 0 for the dataset
+    unsigned long long orderId;
+
+    // Product resolved once through CurrencyRegistry (NONE if malformed)
+    int baseCurrency;
+    int quoteCurrency;
 };
\ No newline at end of file
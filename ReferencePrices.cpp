@@ -0,0 +1,134 @@
+// ==================== ReferencePrices.cpp ====================
+/**
+ * ReferencePrices.cpp
+ * Implementation of the reference price table
+ */
+
+#include "ReferencePrices.h"
+#include <algorithm>
+
+namespace
+{
+    // Best bid and ask of one product in one timeframe
+    struct Best
+    {
+        double bid = 0.0;
+        double ask = 0.0;
+        bool hasBid = false;
+        bool hasAsk = false;
+
+        void add(const OrderBookEntry& order)
+        {
+            if (order.orderType == OrderBookType::bid && (!hasBid || order.price > bid))
+            {
+                bid = order.price;
+                hasBid = true;
+            }
+            else if (order.orderType == OrderBookType::ask && (!hasAsk || order.price < ask))
+            {
+                ask = order.price;
+                hasAsk = true;
+            }
+        }
+
+        bool quoted() const { return hasBid || hasAsk; }
+
+        // Midpoint, or the one side quoted
+        double mid() const
+        {
+            if (hasBid && hasAsk) return (bid + ask) / 2;
+            return hasAsk ? ask : bid;
+        }
+    };
+}
+
+void ReferencePrices::build(const std::vector<OrderBookEntry>& orders)
+{
+    // Each product's first quoted timeframe, found in the same pass: orders
+    // are in timestamp order, so the first time seen is the earliest
+    std::map<std::string, Best> first;
+
+    entries.clear();
+    for (const OrderBookEntry& e : orders)
+    {
+        Entry& entry = entries[e.product];
+        if (e.orderType != OrderBookType::ask && e.orderType != OrderBookType::bid)
+        {
+            continue;
+        }
+
+        if (entry.firstTime.empty())
+        {
+            entry.firstTime = e.timestamp;
+        }
+        if (e.timestamp == entry.firstTime)
+        {
+            first[e.product].add(e);
+        }
+    }
+
+    // A product not quoted yet is priced from its first quotes until the
+    // replay reaches a timeframe that quotes it
+    for (const auto& pair : first)
+    {
+        Entry& entry = entries[pair.first];
+        entry.firstMid = pair.second.mid();
+        entry.mid = entry.firstMid;
+        entry.midTime = entry.firstTime;
+    }
+
+    if (!orders.empty())
+    {
+        update(orders, orders.front().timestamp);
+    }
+}
+
+void ReferencePrices::update(const std::vector<OrderBookEntry>& orders, const std::string& timestamp)
+{
+    std::map<std::string, Best> best;
+
+    // The timeframe is one contiguous range of the sorted orders
+    auto first = std::lower_bound(orders.begin(), orders.end(), timestamp,
+        [](const OrderBookEntry& order, const std::string& time) { return order.timestamp < time; });
+
+    for (auto it = first; it != orders.end() && it->timestamp == timestamp; ++it)
+    {
+        best[it->product].add(*it);
+    }
+
+    for (const auto& pair : best)
+    {
+        if (!pair.second.quoted())
+        {
+            continue;
+        }
+
+        Entry& entry = entries[pair.first];
+        entry.mid = pair.second.mid();
+        entry.midTime = timestamp;
+    }
+}
+
+bool ReferencePrices::find(const std::string& product, Entry& entry) const
+{
+    auto it = entries.find(product);
+    if (it == entries.end())
+    {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+std::map<std::string, double> ReferencePrices::getMids() const
+{
+    std::map<std::string, double> mids;
+    for (const auto& pair : entries)
+    {
+        if (pair.second.mid > 0)
+        {
+            mids[pair.first] = pair.second.mid;
+        }
+    }
+    return mids;
+}
@@ -0,0 +1,43 @@
+// ==================== ReferencePrices.h ====================
+/**
+ * ReferencePrices.h
+ * Per-product reference prices for pricing simulated orders
+ * TASK 4: Built in one pass over the book at load: the mid of the first
+ * timeframe each product is quoted in, and a mid that rolls forward as the
+ * replay advances, so pricing an order is a lookup rather than a scan of
+ * the book
+ */
+
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "OrderBookEntry.h"
+
+class ReferencePrices
+{
+public:
+    struct Entry
+    {
+        double firstMid = 0.0;      // First timeframe that quoted the product
+        std::string firstTime;
+        double mid = 0.0;           // Latest timeframe that quoted the product; starts
+        std::string midTime;        // at firstMid, even if that is ahead of the replay
+    };
+
+    // orders must be in timestamp order (OrderBook::getAllOrders)
+    void build(const std::vector<OrderBookEntry>& orders);
+
+    // Sets the mid of every product quoted at the timestamp from its best bid
+    // and ask (or the one side it has); other products keep their last mid
+    void update(const std::vector<OrderBookEntry>& orders, const std::string& timestamp);
+
+    // False if the product has never been seen
+    bool find(const std::string& product, Entry& entry) const;
+
+    // Latest mid of every product that has one
+    std::map<std::string, double> getMids() const;
+
+private:
+    std::map<std::string, Entry> entries;
+};
@@ -0,0 +1,151 @@
+// ==================== ServerMessage.cpp ====================
+/**
+ * ServerMessage.cpp
+ * Implementation of binary protocol encoding and decoding
+ */
+
+#include "ServerMessage.h"
+#include <cstring>
+
+ServerMessage::ServerMessage(uint8_t type)
+    : offset(1),
+    failed(false)
+{
+    payload.push_back((char)type);
+}
+
+ServerMessage::ServerMessage(const char* _payload, size_t size)
+    : payload(_payload, size),
+    offset(1),
+    failed(size == 0)
+{
+}
+
+uint8_t ServerMessage::getType() const
+{
+    return payload.empty() ? 0 : (uint8_t)payload[0];
+}
+
+// ==================== WRITING ====================
+
+void ServerMessage::writeLE(uint64_t value, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        payload.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+void ServerMessage::putU8(uint8_t value) { writeLE(value, 1); }
+void ServerMessage::putU16(uint16_t value) { writeLE(value, 2); }
+void ServerMessage::putU32(uint32_t value) { writeLE(value, 4); }
+void ServerMessage::putU64(uint64_t value) { writeLE(value, 8); }
+
+void ServerMessage::putF64(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeLE(bits, 8);
+}
+
+void ServerMessage::putString(const std::string& value)
+{
+    size_t length = value.size() > 0xffff ? 0xffff : value.size();
+    putU16((uint16_t)length);
+    payload.append(value, 0, length);
+}
+
+void ServerMessage::appendFrame(std::string& out) const
+{
+    uint32_t size = (uint32_t)payload.size();
+    for (size_t i = 0; i < 4; i++)
+    {
+        out.push_back((char)((size >> (8 * i)) & 0xff));
+    }
+    out += payload;
+}
+
+bool ServerMessage::peekFrame(const std::string& buffer, size_t offset, uint32_t& size)
+{
+    if (buffer.size() - offset < 4)
+    {
+        return false;
+    }
+
+    size = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+        size |= (uint32_t)(unsigned char)buffer[offset + i] << (8 * i);
+    }
+
+    // Oversized frames are reported straight away so the caller can drop them
+    return size > MAX_PAYLOAD || buffer.size() - offset - 4 >= size;
+}
+
+// ==================== READING ====================
+
+bool ServerMessage::take(size_t count)
+{
+    if (failed || payload.size() - offset < count)
+    {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+uint64_t ServerMessage::readLE(size_t count)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        value |= (uint64_t)(unsigned char)payload[offset + i] << (8 * i);
+    }
+    offset += count;
+    return value;
+}
+
+bool ServerMessage::getU8(uint8_t& value)
+{
+    if (!take(1)) return false;
+    value = (uint8_t)readLE(1);
+    return true;
+}
+
+bool ServerMessage::getU16(uint16_t& value)
+{
+    if (!take(2)) return false;
+    value = (uint16_t)readLE(2);
+    return true;
+}
+
+bool ServerMessage::getU32(uint32_t& value)
+{
+    if (!take(4)) return false;
+    value = (uint32_t)readLE(4);
+    return true;
+}
+
+bool ServerMessage::getU64(uint64_t& value)
+{
+    if (!take(8)) return false;
+    value = readLE(8);
+    return true;
+}
+
+bool ServerMessage::getF64(double& value)
+{
+    if (!take(8)) return false;
+    uint64_t bits = readLE(8);
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+bool ServerMessage::getString(std::string& value)
+{
+    uint16_t length;
+    if (!getU16(length) || !take(length)) return false;
+    value.assign(payload, offset, length);
+    offset += length;
+    return true;
+}
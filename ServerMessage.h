@@ -0,0 +1,106 @@
+// ==================== ServerMessage.h ====================
+/**
+ * ServerMessage.h
+ * One message of the trading server's binary protocol
+ *
+ * Frame:   u32 payload length | payload
+ * Payload: u8 type | fields
+ * Fields are little-endian fixed width (u8, u16, u32, u64, f64 as IEEE-754
+ * bits); strings are u16 length + bytes. A response carries the request's
+ * type with RESPONSE set, then a u8 Status, then the body if the status is OK
+ *
+ * Requests and response bodies:
+ *   LOGIN        str username, str password   -> (none)
+ *   PLACE_ORDER  u8 side (0 bid, 1 ask), str product, f64 price, f64 amount
+ *                                             -> u64 orderId
+ *   CANCEL_ORDER u64 orderId                  -> (none)
+ *   WALLET       (none)                       -> u16 n, n x (str currency,
+ *                                                f64 balance, f64 reserved)
+ *   QUOTE        str product                  -> str time, f64 bestBid,
+ *                                                f64 bestAsk, u32 bids, u32 asks
+ *   CANDLES      str product, str interval, u8 side, u16 count
+ *                                             -> u16 n, n x (i64 startMicros,
+ *                                                f64 open, high, low, close,
+ *                                                volume, u64 trades, f64 vwap)
+ *   ADVANCE      (none)                       -> str time
+ *
+ * PLACE_ORDER, CANCEL_ORDER, WALLET and ADVANCE need a successful LOGIN on
+ * the connection first, otherwise they answer NOT_LOGGED_IN. LOGIN answers
+ * REJECTED for a wrong password or a user logged in from another process.
+ * PLACE_ORDER answers REJECTED for an unknown product or when funds are short
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+class ServerMessage
+{
+public:
+    enum Type : uint8_t
+    {
+        LOGIN = 1,
+        PLACE_ORDER = 2,
+        CANCEL_ORDER = 3,
+        WALLET = 4,
+        QUOTE = 5,
+        CANDLES = 6,
+        ADVANCE = 7,
+        RESPONSE = 0x80
+    };
+
+    enum Status : uint8_t
+    {
+        OK = 0,
+        BAD_REQUEST = 1,
+        NOT_LOGGED_IN = 2,
+        REJECTED = 3,
+        NOT_FOUND = 4
+    };
+
+    // Largest payload either side accepts; bigger frames drop the connection
+    static const uint32_t MAX_PAYLOAD = 1 << 20;
+
+    // Starts a message to send
+    explicit ServerMessage(uint8_t type);
+
+    // Takes a received payload (without the length prefix)
+    ServerMessage(const char* payload, size_t size);
+
+    uint8_t getType() const;
+
+    void putU8(uint8_t value);
+    void putU16(uint16_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putF64(double value);
+    void putString(const std::string& value);
+
+    // Reads the next field; false (and the reader stops) once the payload is
+    // exhausted or malformed
+    bool getU8(uint8_t& value);
+    bool getU16(uint16_t& value);
+    bool getU32(uint32_t& value);
+    bool getU64(uint64_t& value);
+    bool getF64(double& value);
+    bool getString(std::string& value);
+
+    // True if every field has been read
+    bool atEnd() const { return offset == payload.size(); }
+
+    // Appends the length-prefixed frame to 'out'
+    void appendFrame(std::string& out) const;
+
+    // If 'buffer' holds a complete frame at 'offset', sets 'size' to its
+    // payload length and returns true. 'size' > MAX_PAYLOAD means garbage
+    static bool peekFrame(const std::string& buffer, size_t offset, uint32_t& size);
+
+private:
+    bool take(size_t count);
+    uint64_t readLE(size_t count);
+    void writeLE(uint64_t value, size_t count);
+
+    std::string payload;
+    size_t offset;
+    bool failed;
+};
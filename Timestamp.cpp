@@ -0,0 +1,137 @@
+// ==================== Timestamp.cpp ====================
+/**
+ * Timestamp.cpp
+ * Implementation of timestamp parsing and formatting
+ */
+
+#include "Timestamp.h"
+#include <cstdio>
+
+namespace
+{
+    // Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's algorithm)
+    long long daysFromCivil(long long y, unsigned m, unsigned d)
+    {
+        y -= m <= 2;
+        const long long era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = (unsigned)(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (long long)doe - 719468;
+    }
+
+    void civilFromDays(long long z, int& y, unsigned& m, unsigned& d)
+    {
+        z += 719468;
+        const long long era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = (unsigned)(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = (int)(yoe + era * 400 + (m <= 2));
+    }
+
+    // Parses exactly 'count' digits starting at 'pos'
+    bool readDigits(const std::string& s, size_t pos, size_t count, long long& value)
+    {
+        if (pos + count > s.size()) return false;
+        value = 0;
+        for (size_t i = pos; i < pos + count; i++)
+        {
+            if (s[i] < '0' || s[i] > '9') return false;
+            value = value * 10 + (s[i] - '0');
+        }
+        return true;
+    }
+}
+
+long long Timestamp::toMicros(const std::string& timestamp)
+{
+    // Layout: 2020/03/17 17:01:24.884492 (time and fraction optional)
+    long long year, month, day, hour = 0, minute = 0, second = 0, micros = 0;
+
+    if (!readDigits(timestamp, 0, 4, year) ||
+        !readDigits(timestamp, 5, 2, month) ||
+        !readDigits(timestamp, 8, 2, day) ||
+        month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return -1;
+    }
+
+    if (timestamp.size() > 10)
+    {
+        if (!readDigits(timestamp, 11, 2, hour) ||
+            !readDigits(timestamp, 14, 2, minute) ||
+            !readDigits(timestamp, 17, 2, second))
+        {
+            return -1;
+        }
+
+        // Fractional seconds, scaled to microseconds whatever their precision
+        if (timestamp.size() > 20 && timestamp[19] == '.')
+        {
+            long long scale = 100000;
+            for (size_t i = 20; i < timestamp.size() && scale > 0; i++)
+            {
+                if (timestamp[i] < '0' || timestamp[i] > '9') break;
+                micros += (timestamp[i] - '0') * scale;
+                scale /= 10;
+            }
+        }
+    }
+
+    long long days = daysFromCivil(year, (unsigned)month, (unsigned)day);
+    long long seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    return seconds * MICROS_PER_SECOND + micros;
+}
+
+std::string Timestamp::fromMicros(long long micros)
+{
+    long long seconds = micros / MICROS_PER_SECOND;
+    long long fraction = micros % MICROS_PER_SECOND;
+    if (fraction < 0)
+    {
+        fraction += MICROS_PER_SECOND;
+        seconds--;
+    }
+
+    long long days = seconds / 86400;
+    long long secondOfDay = seconds % 86400;
+    if (secondOfDay < 0)
+    {
+        secondOfDay += 86400;
+        days--;
+    }
+
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    char buffer[40];
+    if (fraction == 0)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%04d/%02u/%02u %02lld:%02lld:%02lld",
+            year, month, day, secondOfDay / 3600, (secondOfDay / 60) % 60, secondOfDay % 60);
+    }
+    else
+    {
+        std::snprintf(buffer, sizeof(buffer), "%04d/%02u/%02u %02lld:%02lld:%02lld.%06lld",
+            year, month, day, secondOfDay / 3600, (secondOfDay / 60) % 60, secondOfDay % 60, fraction);
+    }
+    return std::string(buffer);
+}
+
+
+void Timestamp::toDate(long long micros, int& year, unsigned& month, unsigned& day)
+{
+    long long days = micros / MICROS_PER_DAY;
+    if (micros % MICROS_PER_DAY < 0) days--;
+    civilFromDays(days, year, month, day);
+}
+
+long long Timestamp::fromDate(int year, unsigned month, unsigned day)
+{
+    return daysFromCivil(year, month, day) * MICROS_PER_DAY;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+// ==================== Timestamp.h ====================
+/**
+ * Timestamp.h
+ * Conversion between "YYYY/MM/DD HH:MM:SS[.ffffff]" strings and integer time
+ * Integer timestamps are microseconds since 1970-01-01 (the strings carry no
+ * timezone, so they are treated as UTC)
+ */
+
+#pragma once
+#include <string>
+
+class Timestamp
+{
+public:
+    // Returns -1 if the string is not a valid timestamp
+    static long long toMicros(const std::string& timestamp);
+    static std::string fromMicros(long long micros);
+
+    // Calendar date of an integer timestamp, and midnight of a date
+    static void toDate(long long micros, int& year, unsigned& month, unsigned& day);
+    static long long fromDate(int year, unsigned month, unsigned day);
+
+    static const long long MICROS_PER_SECOND = 1000000LL;
+    static const long long MICROS_PER_DAY = 86400LL * MICROS_PER_SECOND;
+};
@@ -0,0 +1,40 @@
+// ==================== Trade.cpp ====================
+/**
+ * Trade.cpp
+ * Implementation of a matched trade
+ */
+
+#include "Trade.h"
+
+Trade::Trade(double _price,
+    double _amount,
+    std::string _timestamp,
+    std::string _product,
+    std::string _buyer,
+    std::string _seller,
+    unsigned long long _bidId,
+    unsigned long long _askId)
+    : price(_price),
+    amount(_amount),
+    timestamp(_timestamp),
+    product(_product),
+    buyer(_buyer),
+    seller(_seller),
+    bidId(_bidId),
+    askId(_askId)
+{
+}
+
+OrderBookEntry Trade::buyerFill() const
+{
+    OrderBookEntry fill{ price, amount, timestamp, product, OrderBookType::bidsale, buyer };
+    fill.orderId = bidId;
+    return fill;
+}
+
+OrderBookEntry Trade::sellerFill() const
+{
+    OrderBookEntry fill{ price, amount, timestamp, product, OrderBookType::asksale, seller };
+    fill.orderId = askId;
+    return fill;
+}
@@ -0,0 +1,38 @@
+// ==================== Trade.h ====================
+/**
+ * Trade.h
+ * One match between a resting ask and bid, naming both participants
+ * TASK 4: the matcher reports trades so every account on either side can be
+ * settled, not only the simulated user
+ */
+
+#pragma once
+#include <string>
+#include "OrderBookEntry.h"
+
+class Trade
+{
+public:
+    Trade(double _price,
+        double _amount,
+        std::string _timestamp,
+        std::string _product,
+        std::string _buyer,
+        std::string _seller,
+        unsigned long long _bidId = 0,
+        unsigned long long _askId = 0);
+
+    // The trade as seen by each side: a bidsale for the buyer, an asksale for
+    // the seller, ready for Wallet::settle
+    OrderBookEntry buyerFill() const;
+    OrderBookEntry sellerFill() const;
+
+    double price;
+    double amount;
+    std::string timestamp;
+    std::string product;
+    std::string buyer;
+    std::string seller;
+    unsigned long long bidId;   // OrderBookEntry::orderId of each side
+    unsigned long long askId;
+};
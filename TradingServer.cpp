@@ -0,0 +1,579 @@
+// ==================== TradingServer.cpp ====================
+/**
+ * TradingServer.cpp
+ * Implementation of the epoll trading server
+ */
+
+#include "TradingServer.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    // eventfd the running server waits on; written from the signal handler
+    volatile int stopFd = -1;
+
+    void onStopSignal(int)
+    {
+        if (stopFd >= 0)
+        {
+            uint64_t one = 1;
+            ssize_t ignored = ::write(stopFd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+#endif
+
+    // Responses start with the request type and a status
+    ServerMessage reply(const ServerMessage& request, ServerMessage::Status status)
+    {
+        ServerMessage response(request.getType() | ServerMessage::RESPONSE);
+        response.putU8(status);
+        return response;
+    }
+
+    bool readSide(ServerMessage& request, OrderBookType& type)
+    {
+        uint8_t side;
+        if (!request.getU8(side) || side > 1) return false;
+        type = side == 0 ? OrderBookType::bid : OrderBookType::ask;
+        return true;
+    }
+}
+
+TradingServer::TradingServer(Handler& _handler)
+    : handler(_handler),
+    listenFd(-1),
+    epollFd(-1)
+{
+}
+
+// ==================== REQUESTS ====================
+
+void TradingServer::handle(Connection& connection, ServerMessage& request)
+{
+    ServerMessage bad = reply(request, ServerMessage::BAD_REQUEST);
+    uint8_t type = request.getType();
+
+    if (type == ServerMessage::LOGIN)
+    {
+        std::string username, password;
+        if (!request.getString(username) || !request.getString(password) || !request.atEnd())
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+        bool ok = handler.serverLogin(username, password);
+        if (ok) connection.account = username;
+        reply(request, ok ? ServerMessage::OK : ServerMessage::REJECTED).appendFrame(connection.out);
+        return;
+    }
+
+    if (type == ServerMessage::QUOTE)
+    {
+        std::string product;
+        if (!request.getString(product) || !request.atEnd())
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+        Quote quote = handler.serverGetQuote(product);
+        ServerMessage response = reply(request, ServerMessage::OK);
+        response.putString(quote.time);
+        response.putF64(quote.bestBid);
+        response.putF64(quote.bestAsk);
+        response.putU32(quote.bids);
+        response.putU32(quote.asks);
+        response.appendFrame(connection.out);
+        return;
+    }
+
+    if (type == ServerMessage::CANDLES)
+    {
+        std::string product, intervalName;
+        OrderBookType side;
+        uint16_t count;
+        CandleInterval interval;
+        if (!request.getString(product) || !request.getString(intervalName) ||
+            !readSide(request, side) || !request.getU16(count) || !request.atEnd() ||
+            !CandleInterval::parse(intervalName, interval))
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+
+        // The most recent 'count' candles
+        CandleSeries series = handler.serverGetCandles(product, interval, side);
+        size_t first = series.size() > count ? series.size() - count : 0;
+        ServerMessage response = reply(request, ServerMessage::OK);
+        response.putU16((uint16_t)(series.size() - first));
+        for (size_t i = first; i < series.size(); i++)
+        {
+            response.putU64((uint64_t)series.getStart(i));
+            response.putF64(series.getOpen(i));
+            response.putF64(series.getHigh(i));
+            response.putF64(series.getLow(i));
+            response.putF64(series.getClose(i));
+            response.putF64(series.getVolume(i));
+            response.putU64((uint64_t)series.getTrades(i));
+            response.putF64(series.getVWAP(i));
+        }
+        response.appendFrame(connection.out);
+        return;
+    }
+
+    // Advancing settles every account's orders, so it needs a login too
+    bool accountRequest = type == ServerMessage::PLACE_ORDER ||
+        type == ServerMessage::CANCEL_ORDER || type == ServerMessage::WALLET ||
+        type == ServerMessage::ADVANCE;
+    if (!accountRequest)
+    {
+        bad.appendFrame(connection.out);
+        return;
+    }
+    if (connection.account.empty())
+    {
+        reply(request, ServerMessage::NOT_LOGGED_IN).appendFrame(connection.out);
+        return;
+    }
+
+    if (type == ServerMessage::PLACE_ORDER)
+    {
+        OrderBookType side;
+        std::string product;
+        double price, amount;
+        if (!readSide(request, side) || !request.getString(product) || !request.getF64(price) ||
+            !request.getF64(amount) || !request.atEnd() || !(price > 0) || !(amount > 0))
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+        unsigned long long orderId = handler.serverPlaceOrder(connection.account, side, product, price, amount);
+        if (orderId == 0)
+        {
+            reply(request, ServerMessage::REJECTED).appendFrame(connection.out);
+            return;
+        }
+        ServerMessage response = reply(request, ServerMessage::OK);
+        response.putU64(orderId);
+        response.appendFrame(connection.out);
+        return;
+    }
+
+    if (type == ServerMessage::ADVANCE)
+    {
+        if (!request.atEnd())
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+        ServerMessage response = reply(request, ServerMessage::OK);
+        response.putString(handler.serverAdvance());
+        response.appendFrame(connection.out);
+        return;
+    }
+
+    if (type == ServerMessage::CANCEL_ORDER)
+    {
+        uint64_t orderId;
+        if (!request.getU64(orderId) || !request.atEnd())
+        {
+            bad.appendFrame(connection.out);
+            return;
+        }
+        bool ok = handler.serverCancelOrder(connection.account, orderId);
+        reply(request, ok ? ServerMessage::OK : ServerMessage::NOT_FOUND).appendFrame(connection.out);
+        return;
+    }
+
+    // WALLET
+    if (!request.atEnd())
+    {
+        bad.appendFrame(connection.out);
+        return;
+    }
+    Wallet wallet = handler.serverGetWallet(connection.account);
+    std::map<std::string, double> balances = wallet.getBalances();
+    ServerMessage response = reply(request, ServerMessage::OK);
+    response.putU16((uint16_t)balances.size());
+    for (const auto& pair : balances)
+    {
+        response.putString(pair.first);
+        response.putF64(pair.second);
+        response.putF64(wallet.getReserved(pair.first));
+    }
+    response.appendFrame(connection.out);
+}
+
+#ifdef __linux__
+
+// ==================== EVENT LOOP (LINUX) ====================
+
+TradingServer::~TradingServer()
+{
+    for (auto& pair : connections)
+    {
+        ::close(pair.first);
+    }
+    if (listenFd >= 0) ::close(listenFd);
+    if (epollFd >= 0) ::close(epollFd);
+    if (!socketPath.empty()) ::unlink(socketPath.c_str());
+}
+
+bool TradingServer::isSupported()
+{
+    return true;
+}
+
+bool TradingServer::listen(const std::string& address)
+{
+    if (address.compare(0, 5, "unix:") == 0)
+    {
+        std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        {
+            std::cout << "TradingServer::listen: bad socket path " << path << std::endl;
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        ::unlink(path.c_str());     // Left behind by a previous run
+        if (listenFd < 0 || ::bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            std::cout << "TradingServer::listen: cannot bind " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        socketPath = path;
+    }
+    else if (address.compare(0, 4, "tcp:") == 0)
+    {
+        int port = 0;
+        try
+        {
+            port = std::stoi(address.substr(4));
+        }
+        catch (const std::exception& e)
+        {
+            port = 0;
+        }
+        if (port <= 0 || port > 65535)
+        {
+            std::cout << "TradingServer::listen: bad port in " << address << std::endl;
+            return false;
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int on = 1;
+        if (listenFd >= 0) ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (listenFd < 0 || ::bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            std::cout << "TradingServer::listen: cannot bind port " << port << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        std::cout << "TradingServer::listen: address must be unix:<path> or tcp:<port>" << std::endl;
+        return false;
+    }
+
+    if (::listen(listenFd, SOMAXCONN) < 0)
+    {
+        std::cout << "TradingServer::listen: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    if (epollFd < 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0)
+    {
+        std::cout << "TradingServer::listen: epoll: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TradingServer::run()
+{
+    if (epollFd < 0)
+    {
+        return false;
+    }
+
+    // SIGINT/SIGTERM wake the loop through an eventfd. A handler rather than
+    // signalfd: other threads (AsyncIO) would otherwise take the signal
+    int wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    stopFd = wakeFd;
+    struct sigaction action{};
+    action.sa_handler = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    struct sigaction previousInt, previousTerm;
+    ::sigaction(SIGINT, &action, &previousInt);
+    ::sigaction(SIGTERM, &action, &previousTerm);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    const int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    bool running = wakeFd >= 0;
+
+    while (running)
+    {
+        int ready = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cout << "TradingServer::run: epoll_wait: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == listenFd)
+            {
+                acceptClients();
+                continue;
+            }
+            if (fd == wakeFd)
+            {
+                running = false;
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it != connections.end() && !service(*it->second, events[i].events))
+            {
+                closeConnection(fd);
+            }
+        }
+    }
+
+    ::sigaction(SIGINT, &previousInt, nullptr);
+    ::sigaction(SIGTERM, &previousTerm, nullptr);
+    stopFd = -1;
+    if (wakeFd >= 0) ::close(wakeFd);
+    return true;
+}
+
+void TradingServer::acceptClients()
+{
+    while (true)
+    {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // EAGAIN: backlog drained. Anything else (EMFILE, ...) is retried
+            // on the next wakeup
+            return;
+        }
+
+        // Small responses go out immediately on TCP (no-op on Unix sockets)
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            ::close(fd);
+            continue;
+        }
+
+        std::unique_ptr<Connection> connection(new Connection());
+        connection->fd = fd;
+        connection->events = event.events;
+        connections[fd] = std::move(connection);
+    }
+}
+
+bool TradingServer::service(Connection& connection, unsigned events)
+{
+    if (events & EPOLLERR)
+    {
+        return false;
+    }
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !readFrom(connection))
+    {
+        return false;
+    }
+
+    // Answer, send, and answer again while sending freed up room
+    size_t queued;
+    do
+    {
+        queued = connection.out.size() - connection.sent;
+        if (!processFrames(connection) || !writeTo(connection))
+        {
+            return false;
+        }
+    } while (connection.out.size() - connection.sent < queued && !connection.in.empty());
+
+    size_t backlog = connection.out.size() - connection.sent;
+    if (connection.peerClosed && backlog == 0)
+    {
+        return false;   // Everything it sent has been answered
+    }
+
+    // After a half-close RDHUP stays raised, so only the backlog is watched;
+    // otherwise every epoll_wait would return at once until it drained
+    unsigned wanted = 0;
+    if (!connection.peerClosed)
+    {
+        wanted |= EPOLLRDHUP;
+        if (backlog < OUTPUT_LIMIT) wanted |= EPOLLIN;
+    }
+    if (backlog > 0) wanted |= EPOLLOUT;
+    if (wanted != connection.events)
+    {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = wanted;
+    }
+    return true;
+}
+
+bool TradingServer::readFrom(Connection& connection)
+{
+    char chunk[65536];
+    while (!connection.peerClosed)
+    {
+        ssize_t n = ::read(connection.fd, chunk, sizeof(chunk));
+        if (n > 0)
+        {
+            connection.in.append(chunk, (size_t)n);
+            if (connection.in.size() >= OUTPUT_LIMIT) break;    // Answer some first
+            continue;
+        }
+        if (n == 0)
+        {
+            connection.peerClosed = true;   // Still answer what it sent
+            break;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;
+}
+
+bool TradingServer::processFrames(Connection& connection)
+{
+    // Whole frames in order, until the client's output backs up
+    size_t offset = 0;
+    uint32_t size;
+    while (connection.out.size() - connection.sent < OUTPUT_LIMIT &&
+        ServerMessage::peekFrame(connection.in, offset, size))
+    {
+        if (size == 0 || size > ServerMessage::MAX_PAYLOAD)
+        {
+            return false;
+        }
+        ServerMessage request(connection.in.data() + offset + 4, size);
+        handle(connection, request);
+        offset += 4 + size;
+    }
+    connection.in.erase(0, offset);
+    return true;
+}
+
+bool TradingServer::writeTo(Connection& connection)
+{
+    while (connection.sent < connection.out.size())
+    {
+        ssize_t n = ::send(connection.fd, connection.out.data() + connection.sent,
+            connection.out.size() - connection.sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            connection.sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        return false;
+    }
+
+    if (connection.sent == connection.out.size())
+    {
+        connection.out.clear();
+        connection.sent = 0;
+    }
+    else if (connection.sent > (1 << 20))
+    {
+        // Drop what has gone out so the buffer does not only grow
+        connection.out.erase(0, connection.sent);
+        connection.sent = 0;
+    }
+    return true;
+}
+
+void TradingServer::closeConnection(int fd)
+{
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+#else
+
+// ==================== UNSUPPORTED PLATFORMS ====================
+
+TradingServer::~TradingServer()
+{
+}
+
+bool TradingServer::isSupported()
+{
+    return false;
+}
+
+bool TradingServer::listen(const std::string& address)
+{
+    std::cout << "TradingServer::listen: server mode needs Linux (epoll)" << std::endl;
+    return false;
+}
+
+bool TradingServer::run()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,99 @@
+// ==================== TradingServer.h ====================
+/**
+ * TradingServer.h
+ * Local trading server: order entry, cancellation, wallet and market data
+ * for many clients over a Unix-domain or loopback TCP socket
+ * One thread runs a non-blocking epoll loop (Linux only). Each client sends
+ * length-prefixed binary requests (see ServerMessage.h) and may pipeline
+ * them; every request gets exactly one response, in order. The exchange
+ * itself is reached through a Handler, so requests run on the loop thread
+ * and the handler needs no locking of its own
+ */
+
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "CandleInterval.h"
+#include "CandleSeries.h"
+#include "OrderBookEntry.h"
+#include "ServerMessage.h"
+#include "Wallet.h"
+
+class TradingServer
+{
+public:
+    struct Quote
+    {
+        std::string time;
+        double bestBid;     // 0 if there are no bids
+        double bestAsk;     // 0 if there are no asks
+        uint32_t bids;
+        uint32_t asks;
+    };
+
+    // The exchange behind the server
+    class Handler
+    {
+    public:
+        virtual ~Handler() {}
+        virtual bool serverLogin(const std::string& username, const std::string& password) = 0;
+
+        // New order's ID, or 0 if it was rejected (unknown product or
+        // insufficient funds)
+        virtual unsigned long long serverPlaceOrder(const std::string& account, OrderBookType type,
+            const std::string& product, double price, double amount) = 0;
+        virtual bool serverCancelOrder(const std::string& account, unsigned long long orderId) = 0;
+        virtual Wallet serverGetWallet(const std::string& account) = 0;
+        virtual Quote serverGetQuote(const std::string& product) = 0;
+        virtual CandleSeries serverGetCandles(const std::string& product,
+            const CandleInterval& interval, OrderBookType type) = 0;
+
+        // Matches and settles the current timeframe; returns the new time
+        virtual std::string serverAdvance() = 0;
+    };
+
+    explicit TradingServer(Handler& _handler);
+    ~TradingServer();
+
+    TradingServer(const TradingServer&) = delete;
+    TradingServer& operator=(const TradingServer&) = delete;
+
+    // "unix:/path/to/socket" or "tcp:PORT" (bound to 127.0.0.1)
+    bool listen(const std::string& address);
+
+    // Serves clients until SIGINT or SIGTERM
+    bool run();
+
+    static bool isSupported();
+
+private:
+    struct Connection
+    {
+        int fd;
+        std::string in;         // Bytes received, not yet a whole frame
+        std::string out;        // Responses not yet sent
+        size_t sent = 0;        // Bytes of 'out' already written
+        unsigned events = 0;    // epoll interest currently registered
+        bool peerClosed = false;
+        std::string account;    // Empty until LOGIN succeeds
+    };
+
+    // A client that stops reading stops being read once this much of its
+    // output is queued, so the kernel pushes back on it
+    static const size_t OUTPUT_LIMIT = 4 << 20;
+
+    void acceptClients();
+    bool service(Connection& connection, unsigned events);
+    bool readFrom(Connection& connection);
+    bool processFrames(Connection& connection);
+    bool writeTo(Connection& connection);
+    void closeConnection(int fd);
+    void handle(Connection& connection, ServerMessage& request);
+
+    Handler& handler;
+    int listenFd;
+    int epollFd;
+    std::string socketPath;     // Unix socket to unlink on shutdown
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+};
@@ -0,0 +1,245 @@
+// ==================== TransactionIndex.cpp ====================
+/**
+ * TransactionIndex.cpp
+ * Implementation of the transaction log offset index
+ * Sidecar format: one "offset,username,product" line per indexed record
+ */
+
+#include "TransactionIndex.h"
+#include "CSVReader.h"
+#include <cstdio>
+#include <algorithm>
+#include <unordered_set>
+#include <filesystem>
+
+TransactionIndex::TransactionIndex(std::string _dataFilename, std::string _indexFilename, FileLock& _fileLock)
+    : dataFilename(_dataFilename),
+    indexFilename(_indexFilename),
+    fileLock(_fileLock),
+    loaded(false),
+    indexedEnd(0),
+    sidecarStale(false)
+{
+}
+
+void TransactionIndex::refresh()
+{
+    std::lock_guard<std::recursive_mutex> guard(mutex);
+    FileLock::Guard fileGuard(fileLock, false);
+
+    if (!loaded)
+    {
+        loadSidecar();
+        loaded = true;
+    }
+
+    std::ifstream data(dataFilename, std::ios::binary);
+    if (!data.is_open()) return;
+
+    data.seekg(0, std::ios::end);
+    long long dataSize = data.tellg();
+
+    // The sidecar does not match the log (e.g. the log was replaced): start over
+    if (indexedEnd < 0 || indexedEnd > dataSize)
+    {
+        rebuild();
+    }
+
+    // Catch up on records appended without going through addRecord
+    data.seekg(indexedEnd);
+    std::string line;
+    long long offset = indexedEnd;
+    while (std::getline(data, line))
+    {
+        // A trailing partial line is picked up once it is complete
+        if (data.eof()) break;
+
+        long long end = data.tellg();
+        std::vector<std::string> tokens = CSVReader::tokenise(line, ',');
+        if (tokens.size() == 7)
+        {
+            indexRecord(tokens[0], tokens[3], offset);
+            pendingRecords.push_back(PendingRecord{ offset, tokens[0], tokens[3] });
+        }
+        offset = end;
+        indexedEnd = end;
+    }
+}
+
+void TransactionIndex::flushSidecar()
+{
+    std::lock_guard<std::recursive_mutex> guard(mutex);
+    if (sidecarStale)
+    {
+        // Everything indexed is in memory; replace the sidecar with it
+        rewriteSidecar();
+        sidecarStale = false;
+        pendingRecords.clear();
+    }
+
+    for (const PendingRecord& record : pendingRecords)
+    {
+        writeSidecarLine(record.username, record.product, record.offset);
+    }
+    pendingRecords.clear();
+
+    if (sidecar.is_open())
+    {
+        sidecar.flush();
+    }
+}
+
+void TransactionIndex::loadSidecar()
+{
+    std::ifstream file(indexFilename);
+    std::string line;
+    long long lastOffset = -1;
+    std::unordered_set<long long> seenOffsets;
+    size_t duplicates = 0;
+
+    if (file.is_open())
+    {
+        while (std::getline(file, line))
+        {
+            std::vector<std::string> tokens = CSVReader::tokenise(line, ',');
+            if (tokens.size() != 3) continue;
+
+            try
+            {
+                long long offset = std::stoll(tokens[0]);
+                if (!seenOffsets.insert(offset).second)
+                {
+                    duplicates++;
+                    continue;
+                }
+                indexRecord(tokens[1], tokens[2], offset);
+                if (offset > lastOffset) lastOffset = offset;
+            }
+            catch (const std::exception& e)
+            {
+                // Skip invalid entries
+            }
+        }
+        file.close();
+    }
+
+    // Entries from different processes can interleave; keep each list in log order
+    for (auto& pair : offsetsByUser)
+    {
+        std::sort(pair.second.begin(), pair.second.end());
+    }
+    for (auto& pair : offsetsByUserProduct)
+    {
+        std::sort(pair.second.begin(), pair.second.end());
+    }
+
+    // Several processes index each other's records; shrink the sidecar once
+    // that dominates (at the next flush, under the exclusive lock)
+    if (duplicates > seenOffsets.size())
+    {
+        sidecarStale = true;
+    }
+
+    // Everything up to the end of the last indexed line is covered
+    if (lastOffset >= 0)
+    {
+        std::ifstream data(dataFilename, std::ios::binary);
+        std::string record;
+        data.seekg(lastOffset);
+        if (std::getline(data, record) && !data.eof())
+        {
+            indexedEnd = data.tellg();
+        }
+        else
+        {
+            indexedEnd = -1;  // Stale sidecar, rebuilt by refresh()
+        }
+    }
+}
+
+void TransactionIndex::rewriteSidecar()
+{
+    sidecar.close();
+
+    std::string tempFilename = indexFilename + ".tmp";
+    std::ofstream outFile(tempFilename, std::ios::trunc);
+    for (const auto& pair : offsetsByUserProduct)
+    {
+        size_t separator = pair.first.find('\n');
+        std::string username = pair.first.substr(0, separator);
+        std::string product = pair.first.substr(separator + 1);
+        for (long long offset : pair.second)
+        {
+            outFile << offset << "," << username << "," << product << '\n';
+        }
+    }
+    outFile.close();
+
+    std::error_code error;
+    if (!outFile.fail())
+    {
+        std::filesystem::rename(tempFilename, indexFilename, error);
+    }
+    if (outFile.fail() || error)
+    {
+        std::remove(tempFilename.c_str());
+    }
+}
+
+void TransactionIndex::rebuild()
+{
+    offsetsByUser.clear();
+    offsetsByUserProduct.clear();
+    pendingRecords.clear();
+    indexedEnd = 0;
+
+    // The file is replaced at the next flush, under the exclusive lock
+    sidecarStale = true;
+}
+
+void TransactionIndex::addRecord(const std::string& username, const std::string& product, long long offset, long long end)
+{
+    std::lock_guard<std::recursive_mutex> guard(mutex);
+
+    writeSidecarLine(username, product, offset);
+    indexRecord(username, product, offset);
+    if (end > indexedEnd) indexedEnd = end;
+}
+
+void TransactionIndex::writeSidecarLine(const std::string& username, const std::string& product, long long offset)
+{
+    if (!sidecar.is_open())
+    {
+        sidecar.open(indexFilename, std::ios::app);
+    }
+    if (sidecar.is_open())
+    {
+        // Left buffered: refresh() re-indexes any records the sidecar is missing
+        sidecar << offset << "," << username << "," << product << '\n';
+    }
+}
+
+void TransactionIndex::indexRecord(const std::string& username, const std::string& product, long long offset)
+{
+    offsetsByUser[username].push_back(offset);
+    offsetsByUserProduct[userProductKey(username, product)].push_back(offset);
+}
+
+std::vector<long long> TransactionIndex::getOffsets(const std::string& username)
+{
+    std::lock_guard<std::recursive_mutex> guard(mutex);
+    auto it = offsetsByUser.find(username);
+    return it != offsetsByUser.end() ? it->second : std::vector<long long>();
+}
+
+std::vector<long long> TransactionIndex::getOffsets(const std::string& username, const std::string& product)
+{
+    std::lock_guard<std::recursive_mutex> guard(mutex);
+    auto it = offsetsByUserProduct.find(userProductKey(username, product));
+    return it != offsetsByUserProduct.end() ? it->second : std::vector<long long>();
+}
+
+std::string TransactionIndex::userProductKey(const std::string& username, const std::string& product)
+{
+    return username + "\n" + product;
+}
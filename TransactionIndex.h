@@ -0,0 +1,78 @@
+// ==================== TransactionIndex.h ====================
+/**
+ * TransactionIndex.h
+ * Sidecar offset index for the transaction log
+ * TASK 3: Maps username (and username + product) to the byte offsets of
+ * that user's records in transactions.csv, so history queries only read
+ * the matching lines
+ *
+ * The log is shared between processes: the index reads the log under the
+ * FileLock held shared, and only touches the sidecar when a writer holds
+ * it exclusive. Every process appends what it indexes to the sidecar, so
+ * duplicate sidecar entries are dropped on load
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include "FileLock.h"
+
+class TransactionIndex
+{
+public:
+    TransactionIndex(std::string _dataFilename, std::string _indexFilename, FileLock& _fileLock);
+
+    // Loads the sidecar and indexes any records appended since it was last
+    // written; takes the file lock shared, so the sidecar catches up at the
+    // next flushSidecar()
+    void refresh();
+
+    // Records a line of the log spanning [offset, end)
+    void addRecord(const std::string& username, const std::string& product, long long offset, long long end);
+
+    std::vector<long long> getOffsets(const std::string& username);
+    std::vector<long long> getOffsets(const std::string& username, const std::string& product);
+
+    // Held by writers across "append to log + addRecord" so refresh() never
+    // sees a committed line before it has been indexed
+    std::recursive_mutex& getMutex() { return mutex; }
+
+    // Inter-process lock for the log file itself; hold it exclusive to append
+    FileLock& getFileLock() { return fileLock; }
+
+    // Writes buffered and caught-up sidecar entries out (rewriting the
+    // sidecar if refresh() found it stale); caller holds the file lock
+    // exclusive and calls this before releasing it
+    void flushSidecar();
+
+private:
+    void loadSidecar();
+    void rebuild();
+    void rewriteSidecar();
+    void indexRecord(const std::string& username, const std::string& product, long long offset);
+    void writeSidecarLine(const std::string& username, const std::string& product, long long offset);
+    static std::string userProductKey(const std::string& username, const std::string& product);
+
+    std::string dataFilename;
+    std::string indexFilename;
+    FileLock& fileLock;
+    bool loaded;
+    long long indexedEnd;     // Byte offset in the data file up to which records are indexed
+    std::ofstream sidecar;
+
+    // Found by refresh() under the shared lock, written by flushSidecar()
+    struct PendingRecord
+    {
+        long long offset;
+        std::string username;
+        std::string product;
+    };
+    std::vector<PendingRecord> pendingRecords;
+    bool sidecarStale;        // Rewrite the sidecar from memory at the next flush
+    std::unordered_map<std::string, std::vector<long long>> offsetsByUser;
+    std::unordered_map<std::string, std::vector<long long>> offsetsByUserProduct;
+    std::recursive_mutex mutex;
+};
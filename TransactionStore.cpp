@@ -0,0 +1,367 @@
+// ==================== TransactionStore.cpp ====================
+/**
+ * TransactionStore.cpp
+ * Implementation of the segmented binary transaction store
+ * Segment layout: SegmentHeader followed by up to RECORDS_PER_SEGMENT Records
+ */
+
+#include "TransactionStore.h"
+#include "Timestamp.h"
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+
+namespace
+{
+    // Version 2 added the sized filter; older stores are rebuilt from the CSV log
+    const char SEGMENT_MAGIC[4] = { 'T', 'X', 'S', '2' };
+}
+
+TransactionStore::TransactionStore(std::string _directory, FileLock& _fileLock)
+    : directory(_directory),
+    fileLock(_fileLock),
+    activeSegmentNumber(SIZE_MAX)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    FileLock::Guard guard(fileLock, false);
+    refreshSegmentsLocked();
+}
+
+bool TransactionStore::readHeader(size_t segmentNumber, SegmentHeader& header)
+{
+    std::ifstream file(segmentPath(segmentNumber), std::ios::binary);
+    if (!file.is_open()) return false;
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    // Trust only records that were completely written
+    file.seekg(0, std::ios::end);
+    long long recordBytes = (long long)file.tellg() - (long long)sizeof(header);
+    uint32_t written = (uint32_t)(recordBytes / (long long)sizeof(Record));
+    if (written < header.count) header.count = written;
+    return true;
+}
+
+void TransactionStore::refreshSegmentsLocked()
+{
+    // Only headers are read; records stay on disk until queried.
+    // Earlier segments are full and never change, so start from the last one
+    size_t number = segments.empty() ? 0 : segments.size() - 1;
+    SegmentHeader header;
+    while (readHeader(number, header))
+    {
+        if (number < segments.size()) segments[number] = header;
+        else segments.push_back(header);
+        sealedFilters.resize(segments.size());
+
+        if (header.sealedWords > 0 && sealedFilters[number].empty())
+        {
+            readSealedFilter(number, header);
+        }
+        number++;
+    }
+}
+
+bool TransactionStore::readSealedFilter(size_t segmentNumber, const SegmentHeader& header)
+{
+    std::ifstream file(segmentPath(segmentNumber), std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::vector<uint64_t> filter(header.sealedWords);
+    file.seekg(sizeof(SegmentHeader) + (long long)RECORDS_PER_SEGMENT * sizeof(Record));
+    if (!file.read(reinterpret_cast<char*>(filter.data()), filter.size() * sizeof(uint64_t)))
+    {
+        return false;
+    }
+    sealedFilters[segmentNumber] = std::move(filter);
+    return true;
+}
+
+bool TransactionStore::isEmpty()
+{
+    FileLock::Guard guard(fileLock, false);
+    std::lock_guard<std::mutex> lock(mutex);
+    refreshSegmentsLocked();
+
+    for (const SegmentHeader& header : segments)
+    {
+        if (header.count > 0) return false;
+    }
+    return true;
+}
+
+std::string TransactionStore::segmentPath(size_t segmentNumber) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment_%06zu.bin", segmentNumber);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+bool TransactionStore::startNewSegment()
+{
+    SegmentHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    header.minTimestamp = std::numeric_limits<int64_t>::max();
+    header.maxTimestamp = std::numeric_limits<int64_t>::min();
+
+    activeSegment.close();
+    activeSegment.clear();
+    activeSegment.open(segmentPath(segments.size()),
+        std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!activeSegment.is_open()) return false;
+
+    activeSegment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    segments.push_back(header);
+    sealedFilters.resize(segments.size());
+    activeSegmentNumber = segments.size() - 1;
+    return activeSegment.good();
+}
+
+bool TransactionStore::openActiveSegment()
+{
+    if (segments.empty() || segments.back().count >= RECORDS_PER_SEGMENT)
+    {
+        return startNewSegment();
+    }
+    // Another process may have rolled over to a newer segment since we last wrote
+    if (!activeSegment.is_open() || activeSegmentNumber != segments.size() - 1)
+    {
+        activeSegment.close();
+        activeSegment.clear();
+        activeSegment.open(segmentPath(segments.size() - 1),
+            std::ios::in | std::ios::out | std::ios::binary);
+        activeSegmentNumber = segments.size() - 1;
+    }
+    return activeSegment.is_open();
+}
+
+bool TransactionStore::append(const std::vector<Transaction>& transactions)
+{
+    FileLock::Guard guard(fileLock, true);
+    std::lock_guard<std::mutex> lock(mutex);
+    refreshSegmentsLocked();
+
+    size_t next = 0;
+    while (next < transactions.size())
+    {
+        if (!openActiveSegment()) return false;
+
+        SegmentHeader& header = segments.back();
+        size_t room = RECORDS_PER_SEGMENT - header.count;
+        size_t count = std::min(room, transactions.size() - next);
+
+        // Convert the slice, then write it and the updated header once
+        std::vector<Record> records;
+        records.reserve(count);
+        for (size_t i = next; i < next + count; i++)
+        {
+            long long timestamp = Timestamp::toMicros(transactions[i].getTimestamp());
+            records.push_back(toRecord(transactions[i], timestamp));
+
+            if (timestamp < header.minTimestamp) header.minTimestamp = timestamp;
+            if (timestamp > header.maxTimestamp) header.maxTimestamp = timestamp;
+
+            const std::string& username = transactions[i].getUsername();
+            if (!bloomMayContain(header.userBloom, BLOOM_WORDS, HEADER_BLOOM_HASHES, username))
+            {
+                header.userCount++;
+            }
+            bloomAdd(header.userBloom, BLOOM_WORDS, HEADER_BLOOM_HASHES, username);
+        }
+
+        activeSegment.seekp(sizeof(SegmentHeader) + (long long)header.count * sizeof(Record));
+        activeSegment.write(reinterpret_cast<const char*>(records.data()), count * sizeof(Record));
+        header.count += (uint32_t)count;
+        activeSegment.seekp(0);
+        activeSegment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        activeSegment.flush();
+        if (!activeSegment.good()) return false;
+
+        if (header.count == RECORDS_PER_SEGMENT && !sealActiveSegment()) return false;
+
+        next += count;
+    }
+    return true;
+}
+
+bool TransactionStore::sealActiveSegment()
+{
+    // Full segments never change, so their distinct users are known for good
+    SegmentHeader& header = segments.back();
+    std::vector<Record> records(header.count);
+    activeSegment.seekg(sizeof(SegmentHeader));
+    activeSegment.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+    if (!activeSegment.good()) return false;
+
+    std::unordered_set<std::string> users;
+    for (const Record& record : records)
+    {
+        users.insert(std::string(record.username, strnlen(record.username, FIELD_SIZE)));
+    }
+
+    size_t bits = std::max<size_t>(64, users.size() * SEALED_BITS_PER_USER);
+    std::vector<uint64_t> filter((bits + 63) / 64, 0);
+    for (const std::string& user : users)
+    {
+        bloomAdd(filter.data(), filter.size(), SEALED_BLOOM_HASHES, user);
+    }
+
+    activeSegment.seekp(sizeof(SegmentHeader) + (long long)header.count * sizeof(Record));
+    activeSegment.write(reinterpret_cast<const char*>(filter.data()), filter.size() * sizeof(uint64_t));
+    activeSegment.flush();
+
+    // The header points at the filter only once it is completely written
+    header.sealedWords = (uint32_t)filter.size();
+    activeSegment.seekp(0);
+    activeSegment.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    activeSegment.flush();
+    if (!activeSegment.good()) return false;
+
+    sealedFilters[segments.size() - 1] = std::move(filter);
+    return true;
+}
+
+bool TransactionStore::mayContainUser(size_t segmentNumber, const std::string& username) const
+{
+    const std::vector<uint64_t>& sealed = sealedFilters[segmentNumber];
+    if (!sealed.empty())
+    {
+        return bloomMayContain(sealed.data(), sealed.size(), SEALED_BLOOM_HASHES, username);
+    }
+
+    // A crowded header filter would pass nearly everyone; read the records instead
+    const SegmentHeader& header = segments[segmentNumber];
+    if (header.userCount > HEADER_BLOOM_USERS)
+    {
+        return true;
+    }
+    return bloomMayContain(header.userBloom, BLOOM_WORDS, HEADER_BLOOM_HASHES, username);
+}
+
+std::vector<Transaction> TransactionStore::query(long long fromMicros,
+    long long toMicros,
+    std::string username,
+    std::string product)
+{
+    FileLock::Guard guard(fileLock, false);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (activeSegment.is_open()) activeSegment.flush();
+    refreshSegmentsLocked();
+
+    std::vector<Transaction> results;
+    std::vector<Record> records;
+
+    for (size_t number = 0; number < segments.size(); number++)
+    {
+        const SegmentHeader& header = segments[number];
+
+        // Skip segments that cannot contain a match
+        if (header.count == 0 ||
+            header.maxTimestamp < fromMicros ||
+            header.minTimestamp > toMicros ||
+            (!username.empty() && !mayContainUser(number, username)))
+        {
+            continue;
+        }
+
+        std::ifstream file(segmentPath(number), std::ios::binary);
+        if (!file.is_open()) continue;
+
+        records.resize(header.count);
+        file.seekg(sizeof(SegmentHeader));
+        file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+        size_t readCount = (size_t)file.gcount() / sizeof(Record);
+
+        for (size_t i = 0; i < readCount; i++)
+        {
+            const Record& record = records[i];
+            if (record.timestamp < fromMicros || record.timestamp > toMicros) continue;
+            if (!username.empty() && !fieldEquals(record.username, username)) continue;
+            if (!product.empty() && !fieldEquals(record.product, product)) continue;
+            results.push_back(fromRecord(record));
+        }
+    }
+    return results;
+}
+
+TransactionStore::Record TransactionStore::toRecord(const Transaction& transaction, long long timestamp)
+{
+    Record record;
+    std::memset(&record, 0, sizeof(record));
+
+    // Fields are NUL-padded; longer values are truncated
+    std::strncpy(record.username, transaction.getUsername().c_str(), FIELD_SIZE - 1);
+    std::strncpy(record.product, transaction.getProduct().c_str(), FIELD_SIZE - 1);
+    record.timestamp = timestamp;
+    record.type = (uint8_t)transaction.getType();
+    record.amount = transaction.getAmount();
+    record.price = transaction.getPrice();
+    record.balanceAfter = transaction.getBalanceAfter();
+    return record;
+}
+
+Transaction TransactionStore::fromRecord(const Record& record)
+{
+    return Transaction(std::string(record.username, strnlen(record.username, FIELD_SIZE)),
+        Timestamp::fromMicros(record.timestamp),
+        (TransactionType)record.type,
+        std::string(record.product, strnlen(record.product, FIELD_SIZE)),
+        record.amount,
+        record.price,
+        record.balanceAfter);
+}
+
+bool TransactionStore::fieldEquals(const char* field, const std::string& value)
+{
+    size_t length = strnlen(field, FIELD_SIZE);
+    return value.compare(0, FIELD_SIZE - 1, field, length) == 0;
+}
+
+uint64_t TransactionStore::hashString(const std::string& s)
+{
+    // FNV-1a: stable across compilers, unlike std::hash, since filters are persisted
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : s)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void TransactionStore::bloomAdd(uint64_t* words, size_t wordCount, int hashes, const std::string& key)
+{
+    uint64_t hash = hashString(key.substr(0, FIELD_SIZE - 1));
+    uint64_t h1 = hash & 0xffffffffULL;
+    uint64_t h2 = (hash >> 32) | 1;
+    for (uint64_t i = 0; i < (uint64_t)hashes; i++)
+    {
+        uint64_t bit = (h1 + i * h2) % (wordCount * 64);
+        words[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+bool TransactionStore::bloomMayContain(const uint64_t* words, size_t wordCount, int hashes,
+    const std::string& key)
+{
+    uint64_t hash = hashString(key.substr(0, FIELD_SIZE - 1));
+    uint64_t h1 = hash & 0xffffffffULL;
+    uint64_t h2 = (hash >> 32) | 1;
+    for (uint64_t i = 0; i < (uint64_t)hashes; i++)
+    {
+        uint64_t bit = (h1 + i * h2) % (wordCount * 64);
+        if ((words[bit / 64] & (1ULL << (bit % 64))) == 0) return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+// ==================== TransactionStore.h ====================
+/**
+ * TransactionStore.h
+ * Segmented binary store for transactions with time-range queries
+ * TASK 3: Transactions are kept as fixed-width records in segment files.
+ * Each segment header carries its record count, min/max timestamp and a
+ * bloom filter of the usernames it contains, so queries skip any segment
+ * that cannot hold a match without reading its records. The header's filter
+ * is small and only trusted while the segment has few users; a full segment
+ * gets a filter sized to its distinct users, stored after its records
+ *
+ * Shares the transaction log's FileLock: appends hold it exclusive, queries
+ * shared, and both first re-read segment headers written by other processes.
+ * The FileLock is always taken before the store's mutex, the order the
+ * transaction writer uses when it appends a batch
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include "Transaction.h"
+#include "FileLock.h"
+
+class TransactionStore
+{
+public:
+    TransactionStore(std::string _directory, FileLock& _fileLock);
+
+    bool append(const std::vector<Transaction>& transactions);
+
+    // Timestamps are microseconds (see Timestamp); empty username/product match all
+    std::vector<Transaction> query(long long fromMicros,
+        long long toMicros,
+        std::string username = "",
+        std::string product = "");
+
+    bool isEmpty();
+
+    static const uint32_t RECORDS_PER_SEGMENT = 65536;
+
+private:
+    static const size_t FIELD_SIZE = 24;
+    static const size_t BLOOM_WORDS = 32;        // 2048-bit filter in every header
+    static const uint32_t HEADER_BLOOM_USERS = 200; // Beyond this it is mostly ones
+    static const int HEADER_BLOOM_HASHES = 3;
+    static const int SEALED_BITS_PER_USER = 10;    // About 1% false positives
+    static const int SEALED_BLOOM_HASHES = 7;
+
+    struct Record
+    {
+        char username[FIELD_SIZE];
+        char product[FIELD_SIZE];
+        int64_t timestamp;
+        uint8_t type;
+        uint8_t padding[7];
+        double amount;
+        double price;
+        double balanceAfter;
+    };
+
+    struct SegmentHeader
+    {
+        char magic[4];
+        uint32_t count;
+        int64_t minTimestamp;
+        int64_t maxTimestamp;
+        uint32_t userCount;         // Users added to userBloom, as the filter saw them
+        uint32_t sealedWords;       // Size of the filter after the records, once full
+        uint64_t userBloom[BLOOM_WORDS];
+    };
+
+    // Re-reads the last known header and discovers new segments; caller holds the file lock
+    void refreshSegmentsLocked();
+    bool readHeader(size_t segmentNumber, SegmentHeader& header);
+    bool openActiveSegment();
+    bool startNewSegment();
+
+    // Writes the sized filter after a full segment's records
+    bool sealActiveSegment();
+    bool readSealedFilter(size_t segmentNumber, const SegmentHeader& header);
+    bool mayContainUser(size_t segmentNumber, const std::string& username) const;
+    std::string segmentPath(size_t segmentNumber) const;
+
+    static Record toRecord(const Transaction& transaction, long long timestamp);
+    static Transaction fromRecord(const Record& record);
+    static bool fieldEquals(const char* field, const std::string& value);
+    static uint64_t hashString(const std::string& s);
+    static void bloomAdd(uint64_t* words, size_t wordCount, int hashes, const std::string& key);
+    static bool bloomMayContain(const uint64_t* words, size_t wordCount, int hashes,
+        const std::string& key);
+
+    std::string directory;
+    FileLock& fileLock;
+    std::vector<SegmentHeader> segments;   // Headers of every segment, in order
+    std::vector<std::vector<uint64_t>> sealedFilters;   // Per segment; empty until full
+    std::fstream activeSegment;             // Last segment, open for appending
+    size_t activeSegmentNumber;
+    std::mutex mutex;
+};
@@ -0,0 +1,236 @@
+// ==================== TransactionWriter.cpp ====================
+/**
+ * TransactionWriter.cpp
+ * Implementation of the group-commit transaction writer
+ */
+
+#include "TransactionWriter.h"
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+TransactionWriter::TransactionWriter(std::string _filename,
+    TransactionIndex& _index,
+    TransactionStore* _store,
+    DurabilityPolicy _policy,
+    size_t _capacity,
+    size_t _maxBatch)
+    : filename(_filename),
+    index(_index),
+    store(_store),
+    policy(_policy),
+    capacity(_capacity),
+    maxBatch(_maxBatch),
+    inFlight(0),
+    flushRequested(false),
+    stopping(false),
+    failed(false),
+    file(nullptr),
+    tornTail(false)
+{
+    worker = std::thread(&TransactionWriter::run, this);
+}
+
+TransactionWriter::~TransactionWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+    worker.join();
+
+    if (file != nullptr)
+    {
+        std::fclose(file);
+    }
+}
+
+bool TransactionWriter::submit(const Transaction& transaction)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this] { return queue.size() < capacity || stopping; });
+    if (stopping)
+    {
+        return false;
+    }
+
+    queue.push_back(transaction);
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+void TransactionWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    flushRequested = true;
+    notEmpty.notify_one();
+    drained.wait(lock, [this] { return !flushRequested && queue.empty() && inFlight == 0; });
+}
+
+void TransactionWriter::setPolicy(DurabilityPolicy _policy)
+{
+    flush();
+    policy = _policy;
+}
+
+void TransactionWriter::run()
+{
+    std::vector<Transaction> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return !queue.empty() || stopping || flushRequested; });
+
+            if (queue.empty())
+            {
+                // Nothing queued: every batch is already on disk, so a flush() is done
+                flushRequested = false;
+                drained.notify_all();
+                if (stopping) return;
+                continue;
+            }
+
+            // Take everything queued (up to maxBatch) as one group
+            size_t count = std::min(queue.size(), maxBatch);
+            batch.assign(queue.begin(), queue.begin() + count);
+            queue.erase(queue.begin(), queue.begin() + count);
+            inFlight = count;
+        }
+        notFull.notify_all();
+
+        bool ok = commitBatch(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            inFlight = 0;
+            if (!ok && !failed)
+            {
+                std::cout << "TransactionWriter::run: could not write " << batch.size()
+                    << " records to " << filename << "; reopening the file" << std::endl;
+            }
+            failed = !ok;
+            if (queue.empty())
+            {
+                flushRequested = false;
+                drained.notify_all();
+            }
+        }
+        batch.clear();
+    }
+}
+
+bool TransactionWriter::commitBatch(const std::vector<Transaction>& batch)
+{
+    // Holding the index lock keeps readers from seeing lines that are not indexed yet,
+    // and the file lock keeps other processes from appending in between
+    std::lock_guard<std::recursive_mutex> indexGuard(index.getMutex());
+    FileLock::Guard fileGuard(index.getFileLock(), true);
+
+    // Index whatever other processes appended before computing our offsets
+    index.refresh();
+
+    if (file == nullptr)
+    {
+        file = std::fopen(filename.c_str(), "ab");
+        if (file == nullptr) return false;
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    long long offset = std::ftell(file);
+
+    // After a torn write that could not be truncated, a newline closes the
+    // partial line so it stays a malformed line of its own
+    std::string buffer;
+    if (tornTail)
+    {
+        buffer += '\n';
+    }
+    long long recordsStart = offset + (long long)buffer.size();
+
+    std::vector<long long> ends;
+    ends.reserve(batch.size());
+    for (const Transaction& transaction : batch)
+    {
+        buffer += transaction.toCSVString();
+        buffer += '\n';
+        ends.push_back(offset + (long long)buffer.size());
+    }
+
+    // The batch must be in the file before the lock is released. stdio may
+    // hold all of it, so a short write can surface only when it is flushed
+    if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || !syncFile())
+    {
+        // Reopen for the next batch rather than keep writing to a broken handle.
+        // Closing flushes whatever stdio still buffered, then the file is cut
+        // back to where the batch began so no partial record stays behind
+        std::fclose(file);
+        file = nullptr;
+        if (!truncateFile(offset))
+        {
+            tornTail = true;
+        }
+        return false;
+    }
+    tornTail = false;
+
+    long long start = recordsStart;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        index.addRecord(batch[i].getUsername(), batch[i].getProduct(), start, ends[i]);
+        start = ends[i];
+    }
+
+    index.flushSidecar();
+
+    if (store != nullptr)
+    {
+        return store->append(batch);
+    }
+    return true;
+}
+
+bool TransactionWriter::truncateFile(long long length)
+{
+    if (length < 0)
+    {
+        return false;
+    }
+#ifdef _WIN32
+    int fd = _open(filename.c_str(), _O_WRONLY | _O_BINARY);
+    if (fd < 0) return false;
+    bool ok = _chsize_s(fd, length) == 0;
+    _close(fd);
+    return ok;
+#else
+    return ::truncate(filename.c_str(), (off_t)length) == 0;
+#endif
+}
+
+bool TransactionWriter::syncFile()
+{
+    if (std::fflush(file) != 0)
+    {
+        return false;
+    }
+    if (policy == DurabilityPolicy::sync)
+    {
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+    return true;
+}
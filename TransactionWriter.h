@@ -0,0 +1,78 @@
+// ==================== TransactionWriter.h ====================
+/**
+ * TransactionWriter.h
+ * Background group-commit writer for the transaction log
+ * TASK 3: saveTransaction() only enqueues; a worker thread drains the
+ * bounded queue and appends whole batches with one write per batch
+ * (mirrored into the binary TransactionStore when one is attached)
+ */
+
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Transaction.h"
+#include "TransactionIndex.h"
+#include "TransactionStore.h"
+
+// How hard each committed batch is pushed towards the disk
+enum class DurabilityPolicy
+{
+    flush,      // Handed to the OS after every batch (survives a process crash)
+    sync        // fsync'd after every batch (survives a power loss)
+};
+
+class TransactionWriter
+{
+public:
+    TransactionWriter(std::string _filename,
+        TransactionIndex& _index,
+        TransactionStore* _store = nullptr,
+        DurabilityPolicy _policy = DurabilityPolicy::flush,
+        size_t _capacity = 4096,
+        size_t _maxBatch = 512);
+
+    ~TransactionWriter();
+
+    // Blocks only while the queue is full; returns false once stopped. A batch
+    // that cannot be written is reported and dropped: any part of it that
+    // reached the file is truncated away, and the file is reopened for the
+    // next one
+    bool submit(const Transaction& transaction);
+
+    // Waits until every submitted record has been written and made durable
+    void flush();
+
+    void setPolicy(DurabilityPolicy _policy);
+
+private:
+    void run();
+    bool commitBatch(const std::vector<Transaction>& batch);
+    bool syncFile();
+    bool truncateFile(long long length);
+
+    std::string filename;
+    TransactionIndex& index;
+    TransactionStore* store;     // Optional binary mirror of the log
+    std::atomic<DurabilityPolicy> policy;   // Read by the worker without the mutex
+    size_t capacity;
+    size_t maxBatch;
+
+    std::mutex mutex;
+    std::condition_variable notEmpty;    // Worker waits for records
+    std::condition_variable notFull;     // Producers wait for queue space
+    std::condition_variable drained;     // flush() waits for commits
+    std::deque<Transaction> queue;
+    size_t inFlight;          // Records taken by the worker but not yet committed
+    bool flushRequested;
+    bool stopping;
+    bool failed;              // Last batch was lost; reported once until a write succeeds
+
+    FILE* file;
+    bool tornTail;            // A failed batch could not be cut off; start on a new line
+    std::thread worker;
+};
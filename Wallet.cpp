@@ -1,118 +1,257 @@
-// ==================== Wallet.cpp ====================
-/**
- * Wallet.cpp
- * Implementation of wallet operations
- */
-
-#include "Wallet.h"
-#include "CSVReader.h"
-#include <iostream>
-
-Wallet::Wallet()
-{
-}
-
-void Wallet::insertCurrency(std::string type, double amount)
-{
-    if (amount < 0)
-    {
-        throw std::exception{};
-    }
-
-    double balance = 0;
-    if (currencies.count(type) > 0)
-    {
-        balance = currencies[type];
-    }
-
-    balance += amount;
-    currencies[type] = balance;
-}
-
-bool Wallet::removeCurrency(std::string type, double amount)
-{
-    if (amount < 0 || currencies.count(type) == 0 || currencies[type] < amount)
-    {
-        return false;
-    }
-
-    currencies[type] -= amount;
-    return true;
-}
-
-bool Wallet::containsCurrency(std::string type, double amount)
-{
-    if (currencies.count(type) == 0)
-    {
-        return false;
-    }
-    return currencies[type] >= amount;
-}
-
-bool Wallet::canFulfilOrder(OrderBookEntry order)
-{
-    // Product format: Currency1/Currency2
-    // Ask: need Currency1 to sell
-    // Bid: need Currency2 to buy
-    std::vector<std::string> currencies = CSVReader::tokenise(order.product, '/');
-
-    if (order.orderType == OrderBookType::ask)
-    {
-        double amount = order.amount;
-        std::string currency = currencies[0];
-        std::cout << "Wallet::canFulfilOrder: currency = " << currency << ", amount = " << amount << std::endl;
-        return containsCurrency(currency, amount);
-    }
-
-    if (order.orderType == OrderBookType::bid)
-    {
-        double amount = order.amount * order.price;
-        std::string currency = currencies[1];
-        return containsCurrency(currency, amount);
-    }
-
-    return false;
-}
-
-std::string Wallet::toString()
-{
-    std::string s;
-    for (std::pair<std::string, double> pair : currencies)
-    {
-        std::string currency = pair.first;
-        double amount = pair.second;
-        s += currency + ": " + std::to_string(amount) + "\n";
-    }
-    return s;
-}
-
-void Wallet::processSale(OrderBookEntry& sale)
-{
-    std::vector<std::string> currs = CSVReader::tokenise(sale.product, '/');
-
-    if (sale.orderType == OrderBookType::asksale)
-    {
-        // Sold Currency1, received Currency2
-        double outgoingAmount = sale.amount;
-        std::string outgoingCurrency = currs[0];
-
-        double incomingAmount = sale.amount * sale.price;
-        std::string incomingCurrency = currs[1];
-
-        currencies[incomingCurrency] += incomingAmount;
-        currencies[outgoingCurrency] -= outgoingAmount;
-    }
-
-    if (sale.orderType == OrderBookType::bidsale)
-    {
-        // Bought Currency1, spent Currency2
-        double incomingAmount = sale.amount;
-        std::string incomingCurrency = currs[0];
-
-        double outgoingAmount = sale.amount * sale.price;
-        std::string outgoingCurrency = currs[1];
-
-        currencies[incomingCurrency] += incomingAmount;
-        currencies[outgoingCurrency] -= outgoingAmount;
-    }
-}
\ No newline at end of file
+// ==================== Wallet.cpp ====================
+/**
+ * Wallet.cpp
+ * Implementation of wallet operations
+ */
+
+#include "Wallet.h"
+#include "CurrencyRegistry.h"
+#include <algorithm>
+#include <exception>
+
+Wallet::Wallet()
+{
+}
+
+double& Wallet::balanceOf(int id)
+{
+    if ((size_t)id >= balances.size())
+    {
+        balances.resize(id + 1, 0.0);
+        reserved.resize(id + 1, 0.0);
+        held.resize(id + 1, 0);
+    }
+    held[id] = 1;
+    return balances[id];
+}
+
+bool Wallet::holds(int id, double amount) const
+{
+    if (id < 0 || (size_t)id >= balances.size() || !held[id])
+    {
+        return false;
+    }
+    return balances[id] - reserved[id] >= amount;
+}
+
+void Wallet::insertCurrency(std::string type, double amount)
+{
+    if (amount < 0)
+    {
+        throw std::exception{};
+    }
+
+    balanceOf(CurrencyRegistry::getId(type)) += amount;
+}
+
+bool Wallet::removeCurrency(std::string type, double amount)
+{
+    int id = CurrencyRegistry::findId(type);
+    if (amount < 0 || !holds(id, amount))
+    {
+        return false;
+    }
+
+    balances[id] -= amount;
+    return true;
+}
+
+bool Wallet::containsCurrency(std::string type, double amount) const
+{
+    return holds(CurrencyRegistry::findId(type), amount);
+}
+
+double Wallet::getBalance(const std::string& type) const
+{
+    int id = CurrencyRegistry::findId(type);
+    if (id < 0 || (size_t)id >= balances.size())
+    {
+        return 0.0;
+    }
+    return balances[id];
+}
+
+double Wallet::getAvailable(const std::string& type) const
+{
+    int id = CurrencyRegistry::findId(type);
+    if (id < 0 || (size_t)id >= balances.size())
+    {
+        return 0.0;
+    }
+    return balances[id] - reserved[id];
+}
+
+double Wallet::getReserved(const std::string& type) const
+{
+    int id = CurrencyRegistry::findId(type);
+    if (id < 0 || (size_t)id >= reserved.size())
+    {
+        return 0.0;
+    }
+    return reserved[id];
+}
+
+bool Wallet::canFulfilOrder(const OrderBookEntry& order) const
+{
+    // Product format: Currency1/Currency2
+    // Ask: need Currency1 to sell
+    // Bid: need Currency2 to buy
+    if (order.orderType == OrderBookType::ask)
+    {
+        return holds(order.baseCurrency, order.amount);
+    }
+
+    if (order.orderType == OrderBookType::bid)
+    {
+        return holds(order.quoteCurrency, order.amount * order.price);
+    }
+
+    return false;
+}
+
+// ==================== RESERVATIONS ====================
+
+bool Wallet::reserve(const OrderBookEntry& order)
+{
+    if (order.orderId == 0 || reservations.count(order.orderId) || !canFulfilOrder(order))
+    {
+        return false;
+    }
+
+    Reservation r;
+    r.currency = order.orderType == OrderBookType::ask ? order.baseCurrency : order.quoteCurrency;
+    r.amount = order.amount;
+    r.rate = order.orderType == OrderBookType::ask ? 1.0 : order.price;
+
+    reserved[r.currency] += r.amount * r.rate;
+    reservations[order.orderId] = r;
+    return true;
+}
+
+void Wallet::release(unsigned long long orderId)
+{
+    auto it = reservations.find(orderId);
+    if (it == reservations.end())
+    {
+        return;
+    }
+
+    double& r = reserved[it->second.currency];
+    r -= it->second.amount * it->second.rate;
+    if (r < 0) r = 0;   // Rounding left over from partial fills
+    reservations.erase(it);
+}
+
+void Wallet::consume(const OrderBookEntry& fill)
+{
+    auto it = reservations.find(fill.orderId);
+    if (fill.orderId == 0 || it == reservations.end())
+    {
+        return;
+    }
+
+    // A bid reserved at its limit price; filling below it frees the difference
+    Reservation& r = it->second;
+    double units = std::min(fill.amount, r.amount);
+    reserved[r.currency] -= units * r.rate;
+    r.amount -= units;
+    if (r.amount <= 1e-12)
+    {
+        release(fill.orderId);
+    }
+}
+
+std::string Wallet::toString()
+{
+    std::string s;
+    for (std::pair<std::string, double> pair : getBalances())
+    {
+        std::string currency = pair.first;
+        double amount = pair.second;
+        s += currency + ": " + std::to_string(amount);
+
+        double onHold = getReserved(currency);
+        if (onHold > 0)
+        {
+            s += " (" + std::to_string(onHold) + " reserved for open orders)";
+        }
+        s += "\n";
+    }
+    return s;
+}
+
+std::map<std::string, double> Wallet::getBalances() const
+{
+    std::map<std::string, double> currencies;
+    for (size_t id = 0; id < balances.size(); id++)
+    {
+        if (held[id])
+        {
+            currencies[CurrencyRegistry::getName((int)id)] = balances[id];
+        }
+    }
+    return currencies;
+}
+
+std::map<std::string, double> Wallet::settle(const std::vector<OrderBookEntry>& fills)
+{
+    // Net change per currency ID; a batch usually touches only a few currencies
+    std::vector<double> net;
+    std::vector<int> touched;
+    auto add = [&](int id, double amount)
+    {
+        if ((size_t)id >= net.size()) net.resize(id + 1, 0.0);
+        if (net[id] == 0.0 && std::find(touched.begin(), touched.end(), id) == touched.end())
+        {
+            touched.push_back(id);
+        }
+        net[id] += amount;
+    };
+
+    for (const OrderBookEntry& fill : fills)
+    {
+        if (fill.baseCurrency < 0 || fill.quoteCurrency < 0) continue;
+        consume(fill);
+
+        double value = fill.amount * fill.price;
+        if (fill.orderType == OrderBookType::asksale)
+        {
+            add(fill.quoteCurrency, value);
+            add(fill.baseCurrency, -fill.amount);
+        }
+        else if (fill.orderType == OrderBookType::bidsale)
+        {
+            add(fill.baseCurrency, fill.amount);
+            add(fill.quoteCurrency, -value);
+        }
+    }
+
+    std::map<std::string, double> changed;
+    for (int id : touched)
+    {
+        double& balance = balanceOf(id);
+        balance += net[id];
+        changed[CurrencyRegistry::getName(id)] = balance;
+    }
+    return changed;
+}
+
+void Wallet::processSale(OrderBookEntry& sale)
+{
+    if (sale.baseCurrency < 0 || sale.quoteCurrency < 0) return;
+    consume(sale);
+
+    if (sale.orderType == OrderBookType::asksale)
+    {
+        // Sold Currency1, received Currency2
+        balanceOf(sale.quoteCurrency) += sale.amount * sale.price;
+        balanceOf(sale.baseCurrency) -= sale.amount;
+    }
+
+    if (sale.orderType == OrderBookType::bidsale)
+    {
+        // Bought Currency1, spent Currency2
+        balanceOf(sale.baseCurrency) += sale.amount;
+        balanceOf(sale.quoteCurrency) -= sale.amount * sale.price;
+    }
+}
@@ -1,27 +1,68 @@
-// ==================== Wallet.h ====================
-/**
- * Wallet.h
- * Manages user cryptocurrency holdings
- * TASK 3: Handles deposits, withdrawals, and order fulfillment
- */
-
-#pragma once
-#include <string>
-#include <map>
-#include "OrderBookEntry.h"
-
-class Wallet
-{
-public:
-    Wallet();
-
-    void insertCurrency(std::string type, double amount);
-    bool removeCurrency(std::string type, double amount);
-    bool containsCurrency(std::string type, double amount);
-    bool canFulfilOrder(OrderBookEntry order);
-    void processSale(OrderBookEntry& sale);
-    std::string toString();
-
-private:
-    std::map<std::string, double> currencies;  // Currency -> Amount mapping
-};
\ No newline at end of file
+// ==================== Wallet.h ====================
+/**
+ * Wallet.h
+ * Manages user cryptocurrency holdings
+ * TASK 3: Handles deposits, withdrawals, and order fulfillment
+ * Balances live in a dense array indexed by CurrencyRegistry ID, so order
+ * checks and settlement are array accesses with no string handling.
+ * Funds committed to open orders are reserved per currency: checks run
+ * against the available balance (balance - reserved), so they stay O(1)
+ * however many orders are resting
+ */
+
+#pragma once
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "OrderBookEntry.h"
+
+class Wallet
+{
+public:
+    Wallet();
+
+    void insertCurrency(std::string type, double amount);
+    bool removeCurrency(std::string type, double amount);
+    bool containsCurrency(std::string type, double amount) const;
+    bool canFulfilOrder(const OrderBookEntry& order) const;
+    void processSale(OrderBookEntry& sale);
+
+    // Nets a batch of fills (asksale/bidsale) per currency and applies them in
+    // one update; returns the new balance of every currency that moved
+    std::map<std::string, double> settle(const std::vector<OrderBookEntry>& fills);
+    std::string toString();
+
+    double getBalance(const std::string& type) const;
+    double getAvailable(const std::string& type) const;
+    double getReserved(const std::string& type) const;
+
+    // Sets aside what the order can spend: the base amount for an ask, amount
+    // * price of the quote for a bid. False if too little is available.
+    // The order needs an orderId; fills carrying that ID draw the reservation
+    // down, release() returns whatever is left
+    bool reserve(const OrderBookEntry& order);
+    void release(unsigned long long orderId);
+    bool isReserved(unsigned long long orderId) const { return reservations.count(orderId) > 0; }
+    size_t getOpenOrderCount() const { return reservations.size(); }
+
+    // Bulk export of every balance held, for persistence
+    std::map<std::string, double> getBalances() const;
+
+private:
+    struct Reservation
+    {
+        int currency;
+        double amount;  // Order amount still unfilled
+        double rate;    // Reserved per unit of amount: 1 (ask) or price (bid)
+    };
+
+    bool holds(int id, double amount) const;
+    double& balanceOf(int id);
+    void consume(const OrderBookEntry& fill);
+
+    std::vector<double> balances;   // Currency ID -> Amount
+    std::vector<double> reserved;   // Currency ID -> Amount held by open orders
+    std::vector<char> held;         // Currency ID has an entry in this wallet
+    std::unordered_map<unsigned long long, Reservation> reservations;  // By orderId
+};
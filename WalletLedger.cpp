@@ -0,0 +1,285 @@
+// ==================== WalletLedger.cpp ====================
+/**
+ * WalletLedger.cpp
+ * Implementation of the append-only wallet balance log
+ */
+
+#include "WalletLedger.h"
+#include "CSVReader.h"
+#include <cstdio>
+#include <filesystem>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const std::string GENERATION_HEADER = "#generation,";
+}
+
+WalletLedger::WalletLedger(std::string _filename, AsyncIO& _asyncIO)
+    : filename(_filename),
+    fileLock(_filename + ".lock"),
+    asyncIO(_asyncIO),
+    logFd(-1),
+    pendingWrites(0),
+    writeFailed(false),
+    liveEntries(0),
+    logRecords(0),
+    unreplayedRecords(0),
+    readOffset(0),
+    generation(0)
+{
+    FileLock::Guard guard(fileLock, false);
+    refreshLocked();
+}
+
+WalletLedger::~WalletLedger()
+{
+    flush();
+    closeLog();
+}
+
+void WalletLedger::reset()
+{
+    balances.clear();
+    liveEntries = 0;
+    logRecords = 0;
+    readOffset = 0;
+    closeLog();
+}
+
+void WalletLedger::refreshLocked()
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return;
+
+    // A compaction by any process replaces the file and bumps the generation
+    std::string line;
+    long long fileGeneration = 0;
+    if (std::getline(file, line) && line.compare(0, GENERATION_HEADER.size(), GENERATION_HEADER) == 0)
+    {
+        try
+        {
+            fileGeneration = std::stoll(line.substr(GENERATION_HEADER.size()));
+        }
+        catch (const std::exception& e)
+        {
+            fileGeneration = 0;
+        }
+    }
+
+    file.clear();
+    file.seekg(0, std::ios::end);
+    long long fileSize = file.tellg();
+
+    if (fileGeneration != generation || fileSize < readOffset)
+    {
+        reset();
+        generation = fileGeneration;
+    }
+
+    file.seekg(readOffset);
+    while (std::getline(file, line))
+    {
+        // Leave a partially written last line for the next refresh
+        if (file.eof()) break;
+        readOffset = file.tellg();
+
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        std::vector<std::string> tokens = CSVReader::tokenise(line, ',');
+        if (tokens.size() != 3) continue;
+
+        try
+        {
+            // Later records supersede earlier ones for the same (user, currency)
+            applyRecord(tokens[0], tokens[1], std::stod(tokens[2]));
+            logRecords++;
+        }
+        catch (const std::exception& e)
+        {
+            // Skip invalid records
+        }
+    }
+    unreplayedRecords = 0;
+}
+
+bool WalletLedger::openForAppend()
+{
+    if (logFd < 0)
+    {
+#ifdef _WIN32
+        logFd = _open(filename.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        logFd = open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+#endif
+    }
+    return logFd >= 0;
+}
+
+void WalletLedger::closeLog()
+{
+    if (logFd >= 0)
+    {
+        asyncIO.drain(logFd);
+#ifdef _WIN32
+        _close(logFd);
+#else
+        close(logFd);
+#endif
+        logFd = -1;
+    }
+}
+
+bool WalletLedger::append(std::string username, std::string currency, double amount)
+{
+    std::map<std::string, double> single;
+    single[currency] = amount;
+    return appendAll(username, single);
+}
+
+bool WalletLedger::appendAll(std::string username, const std::map<std::string, double>& userBalances)
+{
+    if (userBalances.empty()) return true;
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (writeFailed) return false;
+
+        // With nothing in flight, take the shared lock and catch up (this also
+        // reopens the log if another process compacted it); otherwise the lock
+        // is already held and no compaction can have happened
+        if (pendingWrites == 0)
+        {
+            fileLock.lockSharedDetached();
+            refreshLocked();
+        }
+        pendingWrites++;
+    }
+
+    if (!openForAppend())
+    {
+        onAppendComplete(false);
+        return false;
+    }
+
+    // Build every record first so the whole wallet lands in a single write
+    std::string batch;
+    for (const auto& pair : userBalances)
+    {
+        batch += formatRecord(username, pair.first, pair.second);
+        batch += '\n';
+        applyRecord(username, pair.first, pair.second);
+        unreplayedRecords++;
+    }
+
+    asyncIO.append(logFd, batch, false, [this](bool ok) { onAppendComplete(ok); });
+
+    size_t records = logRecords + unreplayedRecords;
+    if (records >= COMPACTION_MIN_RECORDS && records > liveEntries * COMPACTION_RATIO)
+    {
+        compact();
+    }
+    return true;
+}
+
+void WalletLedger::onAppendComplete(bool ok)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (!ok) writeFailed = true;
+
+    pendingWrites--;
+    if (pendingWrites == 0)
+    {
+        fileLock.unlockDetached();
+    }
+}
+
+bool WalletLedger::flush()
+{
+    if (logFd >= 0)
+    {
+        asyncIO.drain(logFd);
+    }
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return !writeFailed;
+}
+
+std::map<std::string, double> WalletLedger::getBalances(std::string username)
+{
+    // Our own appends must be in the file before replaying it
+    flush();
+    FileLock::Guard guard(fileLock, false);
+    refreshLocked();
+
+    auto it = balances.find(username);
+    if (it != balances.end())
+    {
+        return it->second;
+    }
+    return std::map<std::string, double>();
+}
+
+bool WalletLedger::compact()
+{
+    flush();
+    FileLock::Guard guard(fileLock, true);
+    refreshLocked();
+
+    std::string tempFilename = filename + ".tmp";
+    std::ofstream outFile(tempFilename, std::ios::trunc | std::ios::binary);
+    if (!outFile.is_open())
+    {
+        return false;
+    }
+
+    outFile << GENERATION_HEADER << (generation + 1) << '\n';
+    for (const auto& user : balances)
+    {
+        for (const auto& currency : user.second)
+        {
+            outFile << formatRecord(user.first, currency.first, currency.second) << '\n';
+        }
+    }
+    outFile.close();
+    if (outFile.fail())
+    {
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+    // Swap the compacted log in atomically; the next refresh reloads it
+    closeLog();
+    std::error_code error;
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error)
+    {
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+    refreshLocked();
+    return true;
+}
+
+void WalletLedger::applyRecord(const std::string& username, const std::string& currency, double amount)
+{
+    std::map<std::string, double>& userBalances = balances[username];
+    if (userBalances.count(currency) == 0)
+    {
+        liveEntries++;
+    }
+    userBalances[currency] = amount;
+}
+
+std::string WalletLedger::formatRecord(const std::string& username, const std::string& currency, double amount)
+{
+    return username + "," + currency + "," + std::to_string(amount);
+}
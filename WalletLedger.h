@@ -0,0 +1,69 @@
+// ==================== WalletLedger.h ====================
+/**
+ * WalletLedger.h
+ * Append-only, log-structured store for wallet balances
+ * TASK 3: Each balance update is appended as a "username,currency,amount"
+ * record; reads are served from an in-memory index and the log is
+ * periodically compacted down to one record per (user, currency)
+ *
+ * Several processes may share the file: appends hold wallet.csv.lock shared,
+ * compaction holds it exclusive, and every access first replays records
+ * other processes appended since the last one
+ *
+ * Appends are submitted through AsyncIO and return without waiting for the
+ * disk; the shared lock is held until the last in-flight append completes
+ */
+
+#pragma once
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <fstream>
+#include "FileLock.h"
+#include "AsyncIO.h"
+#include <mutex>
+
+class WalletLedger
+{
+public:
+    WalletLedger(std::string _filename, AsyncIO& _asyncIO);
+    ~WalletLedger();
+
+    bool append(std::string username, std::string currency, double amount);
+    bool appendAll(std::string username, const std::map<std::string, double>& userBalances);
+    std::map<std::string, double> getBalances(std::string username);
+
+    // Rewrites the log with only the latest record per (user, currency)
+    bool compact();
+
+    // Waits for in-flight appends; false if any of them failed
+    bool flush();
+
+private:
+    // Replays records appended since the last call; caller holds the file lock
+    void refreshLocked();
+    void reset();
+    bool openForAppend();
+    void closeLog();
+    void onAppendComplete(bool ok);
+    void applyRecord(const std::string& username, const std::string& currency, double amount);
+    static std::string formatRecord(const std::string& username, const std::string& currency, double amount);
+
+    // Compact once the log holds this many times more records than live balances
+    static const size_t COMPACTION_RATIO = 4;
+    static const size_t COMPACTION_MIN_RECORDS = 1024;
+
+    std::string filename;
+    FileLock fileLock;
+    AsyncIO& asyncIO;
+    int logFd;             // O_APPEND descriptor used for async appends
+    std::mutex pendingMutex;
+    int pendingWrites;     // Appends submitted but not yet on disk
+    bool writeFailed;
+    std::unordered_map<std::string, std::map<std::string, double>> balances;  // User -> Currency -> Amount
+    size_t liveEntries;    // Distinct (user, currency) pairs
+    size_t logRecords;     // Records replayed from the file
+    size_t unreplayedRecords;  // Our appends not yet replayed (refresh runs only once they land)
+    long long readOffset;  // Bytes of the file already replayed
+    long long generation;  // Bumped by every compaction (header line "#generation,N")
+};